@@ -0,0 +1,68 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::size_t> allocations{0};
+thread_local std::size_t threadAllocations{0};
+
+void* allocate(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    ++threadAllocations;
+    if(void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+/**
+ * Allocates an over-aligned block with malloc, the pointer returned by malloc being stored just before the block so
+ * that it does not depend on the aligned allocation functions of the platform.
+ */
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    const auto align = static_cast<std::size_t>(alignment);
+    auto* raw = static_cast<char*>(allocate(size + align + sizeof(void*)));
+    const auto address = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+    auto* aligned = reinterpret_cast<char*>((address + align - 1) & ~static_cast<std::uintptr_t>(align - 1));
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+}
+
+void deallocateAligned(void* ptr) noexcept
+{
+    if(ptr != nullptr)
+    {
+        std::free(static_cast<void**>(ptr)[-1]);
+    }
+}
+}
+
+std::size_t allocationCount() { return allocations.load(std::memory_order_relaxed); }
+
+std::size_t threadAllocationCount() { return threadAllocations; }
+
+void* operator new(std::size_t size) { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+// GCC cannot see that the memory freed here is the one allocated by the replaced operator new above
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocateAligned(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { deallocateAligned(ptr); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * Counts the allocations of the executables built with AllocationCounter.cpp, which replaces the global allocation
+ * functions of the whole process. The curves library never replaces them: the executables measuring its allocations
+ * link this file, and install threadAllocationCount() with Tracer::setAllocationCounter() to record the allocations
+ * of the traced scopes.
+ */
+
+/// @return the number of allocations made through operator new by all the threads of the process
+std::size_t allocationCount();
+
+/// @return the number of allocations made through operator new by the calling thread
+std::size_t threadAllocationCount();
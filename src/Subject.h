@@ -1,101 +1,137 @@
-#include <iostream>
+#pragma once
+
 #include <algorithm>
-#include <vector>
+#include <cstddef>
 #include <memory>
-#include <string>
-
-class SubjectBase;
+#include <utility>
+#include <vector>
 
-class ObserverBase
+/**
+ * Receives the events published by a Subject.
+ * @tparam Event The type of the events
+ */
+template <typename Event>
+class Observer
 {
 public:
-    virtual ~ObserverBase() = default;
-    virtual void update() = 0;
-    virtual void subscribe(std::shared_ptr<SubjectBase> subject) = 0;
-    virtual void unsubscribe() = 0;
-};
+    virtual ~Observer() = default;
 
-class SubjectBase
-{
-public:
-    virtual ~SubjectBase() = default;
-    virtual void attach(std::shared_ptr<ObserverBase> observer) = 0;
-    virtual void detach(std::shared_ptr<ObserverBase> observer) = 0;
-    virtual void notify() = 0;
+    /**
+     * Called by the subject for each event, the observer may attach or detach observers, including itself.
+     * @param event The event
+     */
+    virtual void update(const Event& event) = 0;
 };
 
-class Subject : public SubjectBase
+/**
+ * Publishes events to the attached observers. The observers can be attached or detached while they are notified,
+ * without copying the list of observers for each notification: an observer attached during a notification only
+ * receives the next events, and an observer detached during a notification does not receive the rest of the current
+ * event. The subject is not thread-safe, the observers are notified on the thread modifying the subject.
+ * @tparam Event The type of the events
+ */
+template <typename Event>
+class Subject
 {
 public:
-    ~Subject() override = default;
-    void attach(std::shared_ptr<ObserverBase> observer) override
+    using ObserverPtr = std::shared_ptr<Observer<Event>>;
+
+    Subject() = default;
+    virtual ~Subject() = default;
+
+    // the observers are attached to an instance, the copies of the subject start without observers
+    Subject(const Subject&) : Subject() { }
+    Subject& operator=(const Subject&) { return *this; }
+
+    /**
+     * Attaches an observer, nothing is done if it is already attached.
+     * @param observer The observer, kept alive until it is detached
+     */
+    void attach(ObserverPtr observer)
     {
-        auto it = std::find(mObservers.begin(), mObservers.end(), observer);
-        if(it == mObservers.end())
+        if(observer && std::find(observers.begin(), observers.end(), observer) == observers.end())
         {
-            mObservers.push_back(observer);
-        }
-        else
-        {
-            std::cout << "(Subject) Attach again, ignored.\n";
+            observers.push_back(std::move(observer));
         }
     }
-    void detach(std::shared_ptr<ObserverBase> observer) override
+
+    /**
+     * Detaches an observer, nothing is done if it is not attached.
+     * @param observer The observer
+     */
+    void detach(const ObserverPtr& observer)
     {
-        auto it = std::find(mObservers.begin(), mObservers.end(), observer);
-        while(it != mObservers.end())
+        if(!observer)
         {
-            mObservers.erase(it);
-            it = std::find(mObservers.begin(), mObservers.end(), observer);
+            return;
         }
-    }
-    void notify() override
-    {
-        for(auto& i : mObservers)
+        const auto it = std::find(observers.begin(), observers.end(), observer);
+        if(it == observers.end())
         {
-            i->update();
+            return;
         }
+        if(notifying == 0)
+        {
+            observers.erase(it);
+            return;
+        }
+        // the notification in progress iterates over the list, the observer is only removed from it once the
+        // notification is over, and kept alive until then as its update may be running
+        detached.push_back(std::move(*it));
     }
 
-private:
-    std::vector<std::shared_ptr<ObserverBase>> mObservers;
-};
-
-class Observer : public ObserverBase, public std::enable_shared_from_this<Observer>
-{
-public:
-    Observer() = default;
-
-    ~Observer() override = default;
-
-    void subscribe(std::shared_ptr<SubjectBase> s) override
+    /**
+     * Notifies the attached observers, in the order of their attachment.
+     * @param event The event
+     */
+    void notify(const Event& event)
     {
-        if(auto subject = mSubject.lock())
+        const Notification notification(*this);
+        // the observers attached by the updates are appended, and are not notified of this event
+        const auto count = observers.size();
+        for(std::size_t i{0}; i < count; ++i)
         {
-            std::cout << "(Observer\n";
-        }
-        else
-        {
-            mSubject = s;
-            s->attach(shared_from_this());
+            // the list may grow during the update, the observer is held either by it or by the detached ones
+            if(auto* observer = observers[i].get())
+            {
+                observer->update(event);
+            }
         }
     }
-    void update() override { std::cout << "(Observe\n"; }
 
-    void unsubscribe() override
+    /// @return the number of attached observers
+    [[nodiscard]] std::size_t observerCount() const
     {
-        if(auto subject = mSubject.lock())
-        {
-            subject->detach(shared_from_this());
-            std::cout << "(Observer  Detached.\n";
-            mSubject.reset();
-        }
-        else
-        {
-            std::cout << "(Observer) Unable to detach or already detached.\n";
-        }
+        return static_cast<std::size_t>(std::count_if(
+            observers.begin(), observers.end(), [](const ObserverPtr& observer) { return observer != nullptr; }));
     }
 
 private:
-    std::weak_ptr<SubjectBase> mSubject;
-};
\ No newline at end of file
+    /// marks the notifications in progress, and removes the detached observers once the outermost one is over
+    class Notification
+    {
+    public:
+        explicit Notification(Subject& p_subject) : subject(p_subject) { ++subject.notifying; }
+        ~Notification()
+        {
+            if(--subject.notifying == 0 && !subject.detached.empty())
+            {
+                subject.observers.erase(std::remove(subject.observers.begin(), subject.observers.end(), nullptr),
+                                        subject.observers.end());
+                subject.detached.clear();
+            }
+        }
+
+        Notification(const Notification&) = delete;
+        Notification& operator=(const Notification&) = delete;
+
+    private:
+        Subject& subject;
+    };
+
+    std::vector<ObserverPtr> observers{};
+    /// the number of nested notifications in progress
+    std::size_t notifying{0};
+    /// the observers detached during a notification, their place in the list being left empty
+    std::vector<ObserverPtr> detached{};
+};
@@ -0,0 +1,104 @@
+#include <curves/approximation.h>
+#include <curves/BezierCurve.h>
+#include <curves/parametrization.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+/**
+ * @return control points drawing a curve with flat stretches and a few tight bends, in pixels
+ */
+std::vector<Point> makeControlPoints(std::size_t nbPoints)
+{
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i) / static_cast<double>(nbPoints - 1);
+        points.emplace_back(50. + 700. * x, 300. + 200. * std::sin(12. * x) * x * x);
+    }
+    return points;
+}
+}
+
+/// a single point with the deCasteljau's algorithm, args: number of control points, number of steps
+void BM_DeCasteljau(benchmark::State& state)
+{
+    const auto points = makeControlPoints(static_cast<std::size_t>(state.range(0)));
+    const auto t = uniformParametrization(static_cast<std::size_t>(state.range(1)));
+    for(auto _ : state)
+    {
+        for(const auto value : t)
+        {
+            benchmark::DoNotOptimize(deCasteljau(points, 0, points.size() - 1, value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(t.size()));
+}
+BENCHMARK(BM_DeCasteljau)->ArgsProduct({{4, 16, 32, 64}, {100, 1000}});
+
+/// all the points at once with the deCasteljau's algorithm, args: number of control points, number of steps
+void BM_DeCasteljauBatch(benchmark::State& state)
+{
+    const auto points = makeControlPoints(static_cast<std::size_t>(state.range(0)));
+    const auto t = uniformParametrization(static_cast<std::size_t>(state.range(1)));
+    std::vector<Point> out(t.size());
+    std::vector<Point> workspace{};
+    for(auto _ : state)
+    {
+        deCasteljau(points, t, out, workspace);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(t.size()));
+}
+BENCHMARK(BM_DeCasteljauBatch)->ArgsProduct({{4, 16, 32, 64}, {100, 1000}});
+
+/// the fixed step sampling, args: number of control points, number of steps
+void BM_BezierUniform(benchmark::State& state)
+{
+    const auto points = makeControlPoints(static_cast<std::size_t>(state.range(0)));
+    BezierCurve curve(static_cast<std::size_t>(state.range(1)));
+    curve.makeFromVector(points);
+    for(auto _ : state)
+    {
+        curve.makeFromVector(points);
+        benchmark::DoNotOptimize(curve.getCurvePoint().data());
+    }
+    state.counters["vertices"] = static_cast<double>(curve.getCurvePoint().size());
+}
+BENCHMARK(BM_BezierUniform)->ArgsProduct({{4, 16, 32}, {100, 1000}});
+
+/// the flatness based sampling, args: number of control points, tolerance in hundredths of pixel
+void BM_BezierAdaptive(benchmark::State& state)
+{
+    const auto points = makeControlPoints(static_cast<std::size_t>(state.range(0)));
+    BezierCurve curve(0);
+    curve.setTessellation(BezierCurve::Tessellation::Adaptive, static_cast<double>(state.range(1)) / 100.);
+    curve.makeFromVector(points);
+    for(auto _ : state)
+    {
+        curve.makeFromVector(points);
+        benchmark::DoNotOptimize(curve.getCurvePoint().data());
+    }
+    state.counters["vertices"] = static_cast<double>(curve.getCurvePoint().size());
+}
+BENCHMARK(BM_BezierAdaptive)->ArgsProduct({{4, 16, 32}, {10, 25, 100}});
+
+/// adding the last control point to the curve, args: number of control points, number of steps
+void BM_BezierAdd(benchmark::State& state)
+{
+    const auto points = makeControlPoints(static_cast<std::size_t>(state.range(0)));
+    const std::vector<Point> head(points.begin(), points.end() - 1);
+    BezierCurve curve(static_cast<std::size_t>(state.range(1)));
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        curve.makeFromVector(head);
+        state.ResumeTiming();
+        curve.add(points.back());
+        benchmark::DoNotOptimize(curve.getCurvePoint().data());
+    }
+}
+BENCHMARK(BM_BezierAdd)->ArgsProduct({{4, 16, 32, 64}, {100, 1000}});
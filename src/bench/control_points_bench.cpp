@@ -0,0 +1,68 @@
+#include <curves/ControlPoints.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+/**
+ * @return uniformly distributed points in a 4096 x 4096 square
+ */
+std::vector<Point> makePoints(std::size_t nbPoints)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(0., 4096.);
+    std::vector<Point> points(nbPoints);
+    for(auto& p : points)
+    {
+        p = {coordinate(generator), coordinate(generator)};
+    }
+    return points;
+}
+}
+
+/// the linear scan, args: number of points
+void BM_GetClosestPointIndex(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto queries = makePoints(256);
+    std::size_t k{0};
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(getClosestPointIndex(points, queries[k++ % queries.size()], 50.));
+    }
+}
+BENCHMARK(BM_GetClosestPointIndex)->RangeMultiplier(10)->Range(100, 1000000);
+
+/// the linear scan of the coordinate arrays, args: number of points
+void BM_CoordinateArraysClosest(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    CoordinateArrays arrays;
+    arrays.assign(points);
+    const auto queries = makePoints(256);
+    std::size_t k{0};
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(arrays.closest(queries[k++ % queries.size()], 50.));
+    }
+}
+BENCHMARK(BM_CoordinateArraysClosest)->RangeMultiplier(10)->Range(100, 1000000);
+
+/// the query of the spatial index, args: number of points
+void BM_ControlPointsPicking(benchmark::State& state)
+{
+    ControlPoints controlPoints;
+    for(const auto& p : makePoints(static_cast<std::size_t>(state.range(0))))
+    {
+        controlPoints.add(p);
+    }
+    const auto queries = makePoints(256);
+    std::size_t k{0};
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(controlPoints.getIndexClosestPoint(queries[k++ % queries.size()], 50.));
+    }
+}
+BENCHMARK(BM_ControlPointsPicking)->RangeMultiplier(10)->Range(100, 1000000);
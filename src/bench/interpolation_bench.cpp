@@ -0,0 +1,194 @@
+#include <curves/ChebycheffSeries.h>
+#include <curves/interpolation.h>
+#include <curves/NewtonPolynomial.h>
+#include <curves/parametrization.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+/**
+ * @return points on a wave going from left to right, in pixels
+ */
+std::vector<Point> makePoints(std::size_t nbPoints)
+{
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        points.emplace_back(50. + 20. * x, 300. + 100. * std::sin(x));
+    }
+    return points;
+}
+
+/// the step between two parameter values, args: number of points, inverse of the step
+double getStep(const benchmark::State& state) { return 1. / static_cast<double>(state.range(1)); }
+
+/// the number of points and the inverse of the step
+const std::vector<std::vector<std::int64_t>> sizes{{4, 8, 16, 32}, {100, 1000}};
+}
+
+void BM_Lagrange(benchmark::State& state)
+{
+    const auto [X, Y] = splitCoordinates(makePoints(static_cast<std::size_t>(state.range(0))));
+    const auto step = getStep(state);
+    for(auto _ : state)
+    {
+        for(auto x = X.front(); x <= X.back(); x += step * (X.back() - X.front()))
+        {
+            benchmark::DoNotOptimize(lagrange(x, X, Y));
+        }
+    }
+}
+BENCHMARK(BM_Lagrange)->ArgsProduct(sizes);
+
+void BM_ApplyLagrangeSubdivision(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto [T, tToEval] = uniformSubdivision(points.size(), getStep(state));
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(applyLagrangeSubdivision(points, T, tToEval));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tToEval.size()));
+}
+BENCHMARK(BM_ApplyLagrangeSubdivision)->ArgsProduct(sizes);
+
+void BM_ApplyBarycentricSubdivision(benchmark::State& state)
+{
+    const auto [X, Y] = splitCoordinates(makePoints(static_cast<std::size_t>(state.range(0))));
+    const auto [T, tToEval] = uniformSubdivision(X.size(), getStep(state));
+    const auto W = barycentricWeights(T);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(applyBarycentricSubdivision(X, Y, T, W, tToEval));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tToEval.size()));
+}
+BENCHMARK(BM_ApplyBarycentricSubdivision)->ArgsProduct(sizes);
+
+void BM_ApplyNewtonSubdivision(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto [T, tToEval] = uniformSubdivision(points.size(), getStep(state));
+    NewtonPolynomial<Point> polynomial;
+    polynomial.build(T, points);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(applyNewtonSubdivision(T, polynomial.getCoefficients(), tToEval));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tToEval.size()));
+}
+BENCHMARK(BM_ApplyNewtonSubdivision)->ArgsProduct(sizes);
+
+void BM_ApplyWindowedLagrangeSubdivision(benchmark::State& state)
+{
+    // many points, each sample only using the 8 closest nodes
+    const auto [X, Y] = splitCoordinates(makePoints(static_cast<std::size_t>(state.range(0))));
+    const auto [T, tToEval] = uniformSubdivision(X.size(), getStep(state));
+    std::vector<Point> curve{};
+    for(auto _ : state)
+    {
+        applyWindowedLagrangeSubdivision(X, Y, T, 8, tToEval, curve);
+        benchmark::DoNotOptimize(curve.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tToEval.size()));
+}
+BENCHMARK(BM_ApplyWindowedLagrangeSubdivision)->ArgsProduct({{32, 1000, 100000}, {10}});
+
+void BM_ChebycheffSeriesBuild(benchmark::State& state)
+{
+    const auto [X, Y] = splitCoordinates(makePoints(static_cast<std::size_t>(state.range(0))));
+    ChebycheffSeries series;
+    for(auto _ : state)
+    {
+        series.build(X, Y);
+        benchmark::DoNotOptimize(series.getCoefficients().data());
+    }
+}
+// powers of two and lengths computed with Bluestein's algorithm
+BENCHMARK(BM_ChebycheffSeriesBuild)->Arg(32)->Arg(33)->Arg(1024)->Arg(1000)->Arg(65536)->Arg(100000);
+
+void BM_ApplyChebycheffSubdivision(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto [X, Y] = splitCoordinates(points);
+    const auto [T, tToEval] = chebycheffSubdivision(2. * getStep(state) / static_cast<double>(points.size()), points);
+    ChebycheffSeries series;
+    series.build(X, Y);
+    std::vector<Point> curve{};
+    for(auto _ : state)
+    {
+        applyChebycheffSubdivision(series.getCoefficients(), tToEval, curve);
+        benchmark::DoNotOptimize(curve.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tToEval.size()));
+}
+BENCHMARK(BM_ApplyChebycheffSubdivision)->ArgsProduct(sizes);
+
+void BM_UniformSubdivision(benchmark::State& state)
+{
+    const auto nbPoints = static_cast<std::size_t>(state.range(0));
+    const auto step = getStep(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(uniformSubdivision(nbPoints, step));
+    }
+}
+BENCHMARK(BM_UniformSubdivision)->ArgsProduct(sizes);
+
+void BM_DistanceSubdivision(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto step = getStep(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(distanceSubdivision(step, points));
+    }
+}
+BENCHMARK(BM_DistanceSubdivision)->ArgsProduct(sizes);
+
+void BM_RootDistanceSubdivision(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto step = getStep(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(rootDistanceSubdivision(step, points));
+    }
+}
+BENCHMARK(BM_RootDistanceSubdivision)->ArgsProduct(sizes);
+
+void BM_DistanceSubdivisionMovePoint(benchmark::State& state)
+{
+    // a drag of the middle point: the nodes following it are shifted and the samples below the end are kept
+    auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto step = getStep(state);
+    const auto idx = points.size() / 2;
+    std::vector<double> T{};
+    std::vector<double> tToEval{};
+    distanceSubdivision(step, points, T, tToEval);
+    double offset{0};
+    for(auto _ : state)
+    {
+        offset = offset > 10. ? -10. : offset + .5;
+        points[idx].y += offset;
+        updateDistanceSubdivision(points, idx, T);
+        createSamples(step, T, tToEval, true);
+        benchmark::DoNotOptimize(tToEval.data());
+    }
+}
+BENCHMARK(BM_DistanceSubdivisionMovePoint)->ArgsProduct(sizes);
+
+void BM_ChebycheffSubdivision(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto step = getStep(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(chebycheffSubdivision(step, points));
+    }
+}
+BENCHMARK(BM_ChebycheffSubdivision)->ArgsProduct(sizes);
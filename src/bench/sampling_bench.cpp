@@ -0,0 +1,117 @@
+#include <curves/interpolation.h>
+#include <curves/NewtonPolynomial.h>
+#include <curves/parametrization.h>
+#include <curves/sampling.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace {
+/**
+ * @return the Newton form of the functional interpolation of points on a wave across a 800x600 window
+ */
+NewtonPolynomial<double> makePolynomial(std::size_t nbPoints)
+{
+    std::vector<double> X{};
+    std::vector<double> Y{};
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        X.push_back(100. + 600. * x / static_cast<double>(nbPoints - 1));
+        Y.push_back(300. + 100. * std::sin(x));
+    }
+    NewtonPolynomial<double> polynomial;
+    polynomial.build(X, Y);
+    return polynomial;
+}
+}
+
+void BM_FixedStepFunctionSampling(benchmark::State& state)
+{
+    // the sampling of the interpolation tool, every 0.05 pixel across the window
+    const auto polynomial = makePolynomial(static_cast<std::size_t>(state.range(0)));
+    std::vector<Point> out{};
+    for(auto _ : state)
+    {
+        out.clear();
+        for(double x = 0; x <= 800.; x += .05)
+        {
+            out.emplace_back(x, polynomial(x));
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["points"] = static_cast<double>(out.size());
+}
+BENCHMARK(BM_FixedStepFunctionSampling)->Arg(4)->Arg(8)->Arg(16);
+
+void BM_AdaptiveFunctionSampling(benchmark::State& state)
+{
+    const auto polynomial = makePolynomial(static_cast<std::size_t>(state.range(0)));
+    const auto f = [&polynomial](double x) { return polynomial(x); };
+    const Viewport viewport{0, 0, 800, 600};
+    std::vector<Point> out{};
+    for(auto _ : state)
+    {
+        adaptiveFunctionSampling(std::cref(f), 0, 800, viewport, .25, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["points"] = static_cast<double>(out.size());
+}
+BENCHMARK(BM_AdaptiveFunctionSampling)->Arg(4)->Arg(8)->Arg(16);
+
+namespace {
+/// the points of the interpolation tool, on a wave across the window
+std::vector<Point> makePoints(std::size_t nbPoints)
+{
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        points.emplace_back(100. + 600. * x / static_cast<double>(nbPoints - 1), 300. + 100. * std::sin(x));
+    }
+    return points;
+}
+}
+
+void BM_StepCurveSampling(benchmark::State& state)
+{
+    // the distance curve sampled every 0.05 pixel of the control polygon
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto T = computeDistanceSubdivision(points);
+    NewtonPolynomial<Point> polynomial;
+    polynomial.build(T, points);
+    std::vector<double> tToEval{};
+    std::vector<Point> curve{};
+    for(auto _ : state)
+    {
+        createSamples(.05, T, tToEval);
+        applyNewtonSubdivision(T, polynomial.getCoefficients(), tToEval, curve);
+        benchmark::DoNotOptimize(curve.data());
+    }
+    state.counters["points"] = static_cast<double>(curve.size());
+}
+BENCHMARK(BM_StepCurveSampling)->Arg(4)->Arg(8)->Arg(16);
+
+void BM_AdaptiveCurveSampling(benchmark::State& state)
+{
+    const auto points = makePoints(static_cast<std::size_t>(state.range(0)));
+    const auto T = computeDistanceSubdivision(points);
+    NewtonPolynomial<Point> polynomial;
+    polynomial.build(T, points);
+    const auto evaluate = [&](const std::vector<double>& t, std::vector<Point>& out) {
+        applyNewtonSubdivision(T, polynomial.getCoefficients(), t, out);
+    };
+    std::vector<double> tToEval{};
+    std::vector<Point> curve{};
+    CurveSamplingWorkspace workspace{};
+    for(auto _ : state)
+    {
+        adaptiveCurveSampling(std::cref(evaluate), T, .25, 4096, tToEval, curve, workspace);
+        benchmark::DoNotOptimize(curve.data());
+    }
+    state.counters["points"] = static_cast<double>(curve.size());
+}
+BENCHMARK(BM_AdaptiveCurveSampling)->Arg(4)->Arg(8)->Arg(16);
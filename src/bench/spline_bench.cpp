@@ -0,0 +1,63 @@
+#include <curves/CubicSpline.h>
+#include <curves/SplineCurve.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+/**
+ * @return points of a noisy trace going from left to right, in pixels
+ */
+std::vector<Point> makeTrace(std::size_t nbPoints)
+{
+    std::vector<Point> points{};
+    points.reserve(nbPoints);
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        points.emplace_back(x, 300. + 100. * std::sin(x * .01) + 5. * std::sin(x * 1.7));
+    }
+    return points;
+}
+
+/// the number of points
+const std::vector<std::vector<std::int64_t>> sizes{{1000, 100000, 1000000}};
+}
+
+void BM_CubicSplineBuild(benchmark::State& state)
+{
+    const auto points = makeTrace(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> T(points.size());
+    for(std::size_t i{0}; i < T.size(); ++i)
+    {
+        T[i] = static_cast<double>(i);
+    }
+    CubicSpline<Point> spline;
+    for(auto _ : state)
+    {
+        spline.build(T, points);
+        benchmark::DoNotOptimize(spline.getMoments().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+BENCHMARK(BM_CubicSplineBuild)->ArgsProduct(sizes);
+
+void BM_SplineCurve(benchmark::State& state)
+{
+    // a drag: moving a point computes the nodes, the spline and 4 samples per point again
+    const auto points = makeTrace(static_cast<std::size_t>(state.range(0)));
+    SplineCurve curve({.25, SplineCurve::Parametrization::Uniform});
+    curve.makeFromVector(points);
+    const auto idx = points.size() / 2;
+    double offset{0};
+    for(auto _ : state)
+    {
+        offset = offset > 10. ? -10. : offset + .5;
+        curve.updateControlPointAtIndex(idx, points[idx] + Point{0, offset}, 1);
+        benchmark::DoNotOptimize(curve.getCurve().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(curve.getCurve().size()));
+}
+BENCHMARK(BM_SplineCurve)->ArgsProduct(sizes)->Unit(benchmark::kMillisecond);
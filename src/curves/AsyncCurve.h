@@ -0,0 +1,238 @@
+#pragma once
+
+#include "Point.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Computes a curve on a background thread, so that the thread handling the input never waits for its computation.
+ * The edits of the control points are queued and applied by the worker before it builds a snapshot of the curve,
+ * consecutive moves of the same point being merged into the last one, so the worker only computes the latest position
+ * however many moves arrive while it is busy. The snapshots are double-buffered: the worker builds into a back buffer
+ * and publishes it once complete, and the render thread reads the last published one without waiting for the build.
+ * An exception thrown by an edit or a build is caught by the worker, which drops the rest of the batch and keeps the
+ * previous snapshot, and is rethrown on the thread reading the next snapshot. The curve then only holds the edits
+ * applied before the error, a caller keeping its own copy of the points can queue an edit setting them again.
+ * @tparam Curve The curve, e.g. InterpolationCurve, only used by the worker once given, the edits applied together
+ * being committed as a single ControlPoints::Transaction, or abandoned if one of them fails
+ * @tparam Snapshot What the render thread draws, e.g. the points of the curve
+ */
+template <typename Curve, typename Snapshot>
+class AsyncCurve
+{
+public:
+    /// a modification of the curve, applied by the worker
+    using Edit = std::function<void(Curve&)>;
+    /// fills the snapshot from the curve, on the worker
+    using Build = std::function<void(const Curve&, Snapshot&)>;
+
+    /**
+     * Starts the worker, which builds a first snapshot of the curve.
+     * @param p_curve The curve
+     * @param p_build The function filling a snapshot from the curve, it is called with the previous content of the
+     * buffer so that it can reuse its memory
+     */
+    AsyncCurve(std::unique_ptr<Curve> p_curve, Build p_build)
+        : curve(std::move(p_curve)), build(std::move(p_build)), front(std::make_shared<Snapshot>())
+    {
+        pending.push_back({[](Curve&) {}, 0, Point{0, 0}});
+        worker = std::thread([this] { work(); });
+    }
+
+    /**
+     * Stops the worker, the pending edits are dropped.
+     */
+    ~AsyncCurve()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        worker.join();
+    }
+
+    AsyncCurve(const AsyncCurve&) = delete;
+    AsyncCurve& operator=(const AsyncCurve&) = delete;
+
+    /**
+     * Queues an edit of the curve, a new snapshot is built once it is applied.
+     * @param p_edit The edit
+     */
+    void edit(Edit p_edit)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back({std::move(p_edit), 0, Point{0, 0}});
+        }
+        wakeup.notify_one();
+    }
+
+    /**
+     * Queues the move of a control point, replacing the pending move of the same point if it is the last edit.
+     * @param idx The index of the point
+     * @param p The new position of the point
+     */
+    void move(std::size_t idx, const Point& p)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if(!pending.empty() && !pending.back().edit && pending.back().index == idx)
+            {
+                pending.back().position = p;
+            }
+            else
+            {
+                pending.push_back({nullptr, idx, p});
+            }
+        }
+        wakeup.notify_one();
+    }
+
+    /**
+     * Builds a new snapshot of the curve, e.g. after changing something read by the build function.
+     */
+    void rebuild()
+    {
+        edit([](Curve&) {});
+    }
+
+    /**
+     * @return the last published snapshot, it is never modified while it is held
+     * @throw the exception thrown by the worker since the previous call, if any, the next call returning the snapshot
+     */
+    [[nodiscard]] std::shared_ptr<const Snapshot> snapshot() const
+    {
+        const std::lock_guard<std::mutex> lock(publication);
+        if(error)
+        {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+        return front;
+    }
+
+    /**
+     * @return the number of published snapshots, to find out whether a new one is available, a failed batch being
+     * counted as well so that its error is read with the next snapshot
+     */
+    [[nodiscard]] std::uint64_t version() const { return published.load(std::memory_order_acquire); }
+
+    /**
+     * Waits until all the queued edits are applied and their snapshot is published.
+     */
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return pending.empty() && !busy; });
+    }
+
+private:
+    /// a queued edit, a move of a point if the edit function is empty
+    struct Pending
+    {
+        Edit edit;
+        std::size_t index;
+        Point position;
+    };
+
+    void work()
+    {
+        std::vector<Pending> applying{};
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeup.wait(lock, [this] { return stopping || !pending.empty(); });
+                if(stopping)
+                {
+                    return;
+                }
+                std::swap(pending, applying);
+                busy = true;
+            }
+            try
+            {
+                apply(applying);
+                // the previous front buffer is reused unless the render thread still holds it; once it is no longer
+                // published its count can only decrease, and the fence orders the reads of its last holder before the
+                // writes below
+                if(!back || back.use_count() > 1)
+                {
+                    back = std::make_shared<Snapshot>();
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                build(*curve, *back);
+                const std::lock_guard<std::mutex> lock(publication);
+                std::swap(front, back);
+            }
+            catch(...)
+            {
+                // the buffer may be partially built, it is built again from scratch by the next batch
+                back.reset();
+                const std::lock_guard<std::mutex> lock(publication);
+                error = std::current_exception();
+            }
+            applying.clear();
+            published.fetch_add(1, std::memory_order_release);
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                busy = false;
+            }
+            idle.notify_all();
+        }
+    }
+
+    /**
+     * Applies a batch of edits.
+     * @param applying The edits, in the order they were queued
+     */
+    void apply(std::vector<Pending>& applying)
+    {
+        // the edits received while the previous snapshot was built are applied as a single batch
+        typename Curve::Transaction transaction(*curve);
+        for(auto& change : applying)
+        {
+            if(change.edit)
+            {
+                change.edit(*curve);
+            }
+            else
+            {
+                curve->updateControlPointAtIndex(change.index, change.position, 0);
+            }
+        }
+        transaction.commit();
+    }
+
+    std::unique_ptr<Curve> curve;
+    Build build;
+
+    /// guards the queue of edits and the state of the worker
+    std::mutex mutex{};
+    std::condition_variable wakeup{};
+    std::condition_variable idle{};
+    std::vector<Pending> pending{};
+    bool busy{false};
+    bool stopping{false};
+
+    /// guards the published snapshot, only held to copy or swap the pointer
+    mutable std::mutex publication{};
+    std::shared_ptr<Snapshot> front;
+    /// the buffer built by the worker
+    std::shared_ptr<Snapshot> back{};
+    /// the exception thrown by the worker, until it is rethrown by snapshot()
+    mutable std::exception_ptr error{};
+    std::atomic<std::uint64_t> published{0};
+
+    std::thread worker{};
+};
@@ -0,0 +1,136 @@
+#include "BernsteinBasis.h"
+
+#include "parametrization.h"
+#include "simd.h"
+
+#include <array>
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+/// the number of rows computed together, so that each block of coordinates is loaded once for all of them
+constexpr std::size_t rowsPerBlock{4};
+
+/**
+ * @return the horizontal sum of the lanes of a pack.
+ */
+double sum(simd::Pack p)
+{
+    std::array<double, simd::Pack::size> lanes{};
+    p.store(lanes.data());
+    double res{0};
+    for(const auto v : lanes)
+    {
+        res += v;
+    }
+    return res;
+}
+
+}
+
+BernsteinBasis::BernsteinBasis(std::size_t p_degree, std::size_t p_steps)
+    : degree(p_degree),
+      steps(p_steps),
+      stride((p_degree + simd::Pack::size) / simd::Pack::size * simd::Pack::size),
+      values((p_steps + 1) * stride, 0.0)
+{
+    const auto T = uniformParametrization(steps);
+    for(std::size_t s = 0; s < T.size(); ++s)
+    {
+        // raising the degree one step at a time, as the deCasteljau's algorithm does, keeps the values accurate
+        const auto t = T[s];
+        auto* row = &values[s * stride];
+        row[0] = 1.0;
+        for(std::size_t k = 1; k <= degree; ++k)
+        {
+            row[k] = t * row[k - 1];
+            for(std::size_t i = k - 1; i > 0; --i)
+            {
+                row[i] = (1 - t) * row[i] + t * row[i - 1];
+            }
+            row[0] *= (1 - t);
+        }
+    }
+}
+
+bool BernsteinBasis::fits(std::size_t degree, std::size_t steps)
+{
+    return (degree + 1) * (steps + 1) <= maxSize;
+}
+
+std::shared_ptr<const BernsteinBasis> BernsteinBasis::get(std::size_t degree, std::size_t steps)
+{
+    static std::mutex mutex;
+    static std::map<std::pair<std::size_t, std::size_t>, std::weak_ptr<const BernsteinBasis>> cache;
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = cache[{degree, steps}];
+    auto basis = entry.lock();
+    if(!basis)
+    {
+        basis = std::make_shared<const BernsteinBasis>(degree, steps);
+        entry = basis;
+        // forgetting the matrices that are not used anymore
+        for(auto it = cache.begin(); it != cache.end();)
+        {
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+        }
+    }
+    return basis;
+}
+
+void BernsteinBasis::evaluate(Span<const double> X, Span<const double> Y, Span<Point> out) const
+{
+    assert(X.size() == stride);
+    assert(Y.size() == stride);
+    assert(out.size() == steps + 1);
+    const auto nbRows = steps + 1;
+    std::size_t s = 0;
+    for(; s + rowsPerBlock <= nbRows; s += rowsPerBlock)
+    {
+        std::array<simd::Pack, rowsPerBlock> xs{};
+        std::array<simd::Pack, rowsPerBlock> ys{};
+        xs.fill(simd::Pack::broadcast(0.0));
+        ys.fill(simd::Pack::broadcast(0.0));
+        for(std::size_t i = 0; i < stride; i += simd::Pack::size)
+        {
+            const auto x = simd::Pack::load(&X[i]);
+            const auto y = simd::Pack::load(&Y[i]);
+            for(std::size_t r = 0; r < rowsPerBlock; ++r)
+            {
+                const auto b = simd::Pack::load(&values[(s + r) * stride + i]);
+                xs[r] = xs[r] + b * x;
+                ys[r] = ys[r] + b * y;
+            }
+        }
+        for(std::size_t r = 0; r < rowsPerBlock; ++r)
+        {
+            out[s + r] = {sum(xs[r]), sum(ys[r])};
+        }
+    }
+    for(; s < nbRows; ++s)
+    {
+        auto xs = simd::Pack::broadcast(0.0);
+        auto ys = simd::Pack::broadcast(0.0);
+        for(std::size_t i = 0; i < stride; i += simd::Pack::size)
+        {
+            const auto b = simd::Pack::load(&values[s * stride + i]);
+            xs = xs + b * simd::Pack::load(&X[i]);
+            ys = ys + b * simd::Pack::load(&Y[i]);
+        }
+        out[s] = {sum(xs), sum(ys)};
+    }
+}
+
+void BernsteinBasis::addColumn(std::size_t i, const Point& delta, Span<Point> out) const
+{
+    assert(i <= degree);
+    assert(out.size() == steps + 1);
+    for(std::size_t s = 0; s < out.size(); ++s)
+    {
+        out[s] += values[s * stride + i] * delta;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Point.h"
+#include "Span.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * The values of the Bernstein polynomials of a given degree at steps + 1 regularly spaced values of t in [0, 1].
+ * With this matrix, sampling a Bezier curve is a matrix-vector product with its control points, which costs
+ * O(steps * n) instead of the O(steps * n^2) of the deCasteljau's algorithm. The matrices are shared by all the
+ * curves with the same degree and number of steps through get().
+ */
+class BernsteinBasis
+{
+public:
+    /// the maximum number of values of a matrix, larger curves are better sampled with the deCasteljau's algorithm
+    static constexpr std::size_t maxSize{1U << 20U};
+
+    /**
+     * Computes the matrix.
+     * @param p_degree The degree of the Bernstein polynomials, i.e. the number of control points minus one
+     * @param p_steps The number of steps for t
+     */
+    BernsteinBasis(std::size_t p_degree, std::size_t p_steps);
+
+    /**
+     * Returns the matrix for the given degree and number of steps, computing it only if no curve uses it already.
+     * @param degree The degree of the Bernstein polynomials
+     * @param steps The number of steps for t
+     * @return the shared matrix
+     */
+    [[nodiscard]] static std::shared_ptr<const BernsteinBasis> get(std::size_t degree, std::size_t steps);
+
+    /**
+     * @param degree The degree of the Bernstein polynomials
+     * @param steps The number of steps for t
+     * @return true if the matrix is small enough to be used
+     */
+    [[nodiscard]] static bool fits(std::size_t degree, std::size_t steps);
+
+    /**
+     * @param sample The index of the t value
+     * @param i The index of the Bernstein polynomial
+     * @return the value of the i-th Bernstein polynomial at the sample-th t value
+     */
+    [[nodiscard]] double operator()(std::size_t sample, std::size_t i) const { return values[sample * stride + i]; }
+
+    /**
+     * Computes the points of the Bezier curve for each t value.
+     * @param X The x coordinates of the control points, padded with zeros to paddedSize() elements
+     * @param Y The y coordinates of the control points, padded with zeros to paddedSize() elements
+     * @param out The points of the curve, one for each t value
+     */
+    void evaluate(Span<const double> X, Span<const double> Y, Span<Point> out) const;
+
+    /**
+     * Moves the points of a Bezier curve after the displacement of one of its control points, i.e. adds the
+     * displacement weighted by the value of the corresponding Bernstein polynomial to each point, in O(steps).
+     * @param i The index of the moved control point
+     * @param delta The displacement of the control point
+     * @param out The points of the curve, one for each t value
+     */
+    void addColumn(std::size_t i, const Point& delta, Span<Point> out) const;
+
+    [[nodiscard]] std::size_t getDegree() const { return degree; }
+    [[nodiscard]] std::size_t getSteps() const { return steps; }
+    /// @return the number of coordinates expected by evaluate(), i.e. the number of control points rounded up
+    [[nodiscard]] std::size_t paddedSize() const { return stride; }
+
+private:
+    std::size_t degree;
+    std::size_t steps;
+    /// the length of a row, padded so that each row starts on a whole SIMD block
+    std::size_t stride;
+    /// the matrix, with a row for each t value and a column for each control point
+    std::vector<double> values;
+};
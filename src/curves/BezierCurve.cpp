@@ -1,31 +1,43 @@
 #include "BezierCurve.h"
 
 #include "approximation.h"
+#include "parametrization.h"
+#include "Tracer.h"
+
+#include <algorithm>
 #include <utility>
 
 BezierCurve::BezierCurve(std::size_t nbSteps)
 {
     this->steps = nbSteps;
+    parameters = uniformParametrization(steps);
     curvePoints.reserve(steps + 1);
 }
 
 bool BezierCurve::deleteControlPoint(const Point& p, double threshold)
 {
-    //    if(::deletePoint(controlPoints, p, threshold))
-    if(ControlPoints::deleteControlPoint(p, threshold))
+    const auto idx = getIndexClosestPoint(p, threshold);
+    if(idx.has_value())
     {
-        make();
+        deleteControlPointAtIndex(idx.value());
         return true;
     }
     return false;
 }
 
+void BezierCurve::deleteControlPointAtIndex(std::size_t idx)
+{
+    ControlPoints::deleteControlPointAtIndex(idx);
+    requestRebuild();
+    publish({CurveChange::Edit::Remove, {idx, idx + 1}, IndexRange::all()});
+}
+
 bool BezierCurve::updateControlPoint(const Point& p_old, const Point& p_new, double threshold)
 {
-    //    if(updatePoint(controlPoints, p_old, p_new, threshold))
-    if(ControlPoints::updateControlPoint(p_old, p_new, threshold))
+    const auto idx = getIndexClosestPoint(p_old, threshold);
+    if(idx.has_value())
     {
-        make();
+        updateControlPointAtIndex(idx.value(), p_new, threshold);
         return true;
     }
     return false;
@@ -33,63 +45,133 @@ bool BezierCurve::updateControlPoint(const Point& p_old, const Point& p_new, dou
 
 void BezierCurve::updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold)
 {
+    CURVES_TRACE_SCOPE("BezierCurve::updateControlPointAtIndex");
+    const auto p_old = idx < size() ? getControlPoints()[idx] : p_new;
     ControlPoints::updateControlPointAtIndex(idx, p_new, threshold);
+    if(!deferRebuild())
+    {
+        move(idx, p_new - p_old);
+    }
+    // the Bernstein polynomial of a point vanishes at t = 0 and t = 1, unless it is the first or the last point
+    auto samples = IndexRange::all();
+    if(tessellation == Tessellation::Uniform)
+    {
+        samples = {std::min<std::size_t>(idx, 1), idx + 1 >= size() ? parameters.size() : parameters.size() - 1};
+    }
+    publish({CurveChange::Edit::Move, {idx, idx + 1}, samples});
+}
+
+void BezierCurve::move(std::size_t idx, const Point& displacement)
+{
+    // moving a control point moves each curve point by the displacement weighted by its Bernstein polynomial
+    if(tessellation == Tessellation::Uniform && basis && basis->getDegree() + 1 == size() &&
+       displacements < maxDisplacements)
+    {
+        basis->addColumn(idx, displacement, curvePoints);
+        ++displacements;
+        return;
+    }
     make();
 }
 
 void BezierCurve::make()
 {
-    curvePoints.clear();
-    double incr = 1.0 / static_cast<double>(steps);
-    for(double t = 0.0; t <= 1.0; t += incr) // sampling t at regular intervals
+    CURVES_TRACE_SCOPE("BezierCurve::make");
+    displacements = 0;
+    if(size() == 0)
+    {
+        curvePoints.clear();
+        return;
+    }
+    if(tessellation == Tessellation::Adaptive)
+    {
+        adaptiveTessellation(getControlPoints(), tolerance, curvePoints, workspace);
+        return;
+    }
+    curvePoints.resize(parameters.size());
+    const auto degree = size() - 1;
+    if(!BernsteinBasis::fits(degree, steps))
     {
         // performing deCasteljau for each t
-        curvePoints.push_back(deCasteljau(0, size() - 1, t));
+        basis.reset();
+        deCasteljau(0, curvePoints);
+        return;
+    }
+    if(!basis || basis->getDegree() != degree)
+    {
+        basis = BernsteinBasis::get(degree, steps);
     }
+    xCoordinates.assign(basis->paddedSize(), 0.0);
+    yCoordinates.assign(basis->paddedSize(), 0.0);
+    for(std::size_t i{0}; i <= degree; ++i)
+    {
+        xCoordinates[i] = getControlPoints()[i].x;
+        yCoordinates[i] = getControlPoints()[i].y;
+    }
+    basis->evaluate(xCoordinates, yCoordinates, curvePoints);
 }
 
-void BezierCurve::makeFromVector(const std::vector<Point>& control_points)
+void BezierCurve::makeFromVector(const std::vector<Point>& control_points) { setControlPoints(control_points); }
+
+void BezierCurve::setControlPoints(const std::vector<Point>& control_points)
 {
-    setControlPoints(control_points);
-    make();
+    ControlPoints::setControlPoints(control_points);
+    requestRebuild();
+    publish({});
 }
 
 void BezierCurve::add(Point p)
 {
+    CURVES_TRACE_SCOPE("BezierCurve::add");
     ControlPoints::add(p);
-    const double incr = 1.0 / static_cast<double>(steps);
+    if(!deferRebuild())
+    {
+        append(p);
+    }
+    publish({CurveChange::Edit::Append, {size() - 1, size()}, IndexRange::all()});
+}
+
+void BezierCurve::append(const Point& p)
+{
+    if(tessellation == Tessellation::Adaptive)
+    {
+        make();
+        return;
+    }
     // if this is the first point, just fill the array with the point
     //    if(controlPoints.size() == 1)
     if(size() == 1)
     {
-        for(double t = 0.0; t <= 1.0; t += incr)
-        {
-            curvePoints.push_back(p);
-        }
+        curvePoints.assign(parameters.size(), p);
+        return;
+    }
+    // the product with the Bernstein basis is cheaper than updating the curve with the deCasteljau's algorithm
+    if(BernsteinBasis::fits(size() - 1, steps))
+    {
+        make();
         return;
     }
     // otherwise, you can use the already drawn curve
-    std::size_t i{0};
-    for(double t = 0.0; t <= 1.0; t += incr)
+    tailPoints.resize(parameters.size());
+    deCasteljau(1, tailPoints);
+    for(std::size_t i{0}; i < parameters.size(); ++i)
     {
-        //        curvePoints[i] = lerp(curvePoints[i], deCasteljau(1, controlPoints.size() - 1, t), t);
-        curvePoints[i] = lerp(curvePoints[i], deCasteljau(1, size() - 1, t), t);
-        ++i;
+        curvePoints[i] = lerp(curvePoints[i], tailPoints[i], parameters[i]);
     }
 }
 
-Point BezierCurve::deCasteljau(std::size_t start, std::size_t end, double t) const
+void BezierCurve::deCasteljau(std::size_t start, Span<Point> out)
+{
+    const Span<const Point> points{getControlPoints()};
+    ::deCasteljau(points.subspan(start, points.size() - start), parameters, out, workspace);
+}
+
+void BezierCurve::setTessellation(Tessellation mode, double p_tolerance)
 {
-//    // array storing the intermediate points
-//    std::vector<Point> temp(getControlPoints());
-//    // lerping n (n - 1) / 2 times
-//    for(std::size_t i = end; i > start; --i)
-//    {
-//        for(std::size_t j = start; j < i; ++j)
-//            temp[j] = lerp(temp[j], temp[j + 1], t);
-//    }
-//    return temp[start];
-    return ::deCasteljau(getControlPoints(), start, end, t);
+    tessellation = mode;
+    tolerance = p_tolerance;
+    requestRebuild();
+    publish({CurveChange::Edit::Any, {}, IndexRange::all()});
 }
 
 void BezierCurve::reset()
@@ -97,6 +179,8 @@ void BezierCurve::reset()
     //    controlPoints.clear();
     ControlPoints::reset();
     curvePoints.clear();
+    basis.reset();
+    publish({});
 }
 
 std::optional<Point> BezierCurve::getClosestPoint(const Point& p, double threshold) const
@@ -1,16 +1,27 @@
 #pragma once
 
 #include "Point.h"
+#include "BernsteinBasis.h"
 #include "ControlPoints.h"
+#include "Span.h"
 
 #include <glm/glm.hpp>
 
+#include <memory>
 #include <optional>
 #include <vector>
 
 class BezierCurve : public ControlPoints
 {
 public:
+    /// the ways of sampling the curve
+    enum class Tessellation
+    {
+        /// steps + 1 regularly spaced values of t
+        Uniform,
+        /// as many points as needed to stay within a distance tolerance from the curve
+        Adaptive
+    };
 
     /**
      * The constructor to make a curve drawer.
@@ -36,33 +47,80 @@ public:
     std::optional<Point> getClosestPoint(const Point& p, double threshold) const override;
 
     bool deleteControlPoint(const Point& p, double threshold) override;
+    void deleteControlPointAtIndex(std::size_t idx) override;
 
     bool updateControlPoint(const Point& p_old, const Point& p_new, double threshold) override;
     void updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold) override;
 
     void reset() override;
 
+    void setControlPoints(const std::vector<Point>& control_points) override;
+
     [[nodiscard]] const auto& getCurvePoint() const {return curvePoints;}
 
+    /**
+     * Sets the way the curve is sampled and computes the curve again.
+     * @param mode The tessellation mode
+     * @param p_tolerance The maximum distance between the curve and its points for the adaptive mode, e.g. in pixels
+     */
+    void setTessellation(Tessellation mode, double p_tolerance = .25);
+
+    [[nodiscard]] Tessellation getTessellation() const { return tessellation; }
+
+protected:
+    void rebuild() override { make(); }
+
 private:
     /**
-     * Applies the deCasteljau's algorithm between the start and the end index of the controlPoints
+     * Applies the deCasteljau's algorithm between the start and the last index of the controlPoints for each t value
      * @param start The starting index
-     * @param end The ending index
-     * @param t The t value
-     * @return The generated point on the curve
+     * @param out The generated points on the curve, one for each t value
      */
-    [[nodiscard]] Point deCasteljau(size_t start, size_t end, double t) const;
+    void deCasteljau(std::size_t start, Span<Point> out);
+
+    /**
+     * Updates the curve after adding a point at the end of the control points.
+     * @param p The added point
+     */
+    void append(const Point& p);
+
+    /**
+     * Updates the curve after moving a control point.
+     * @param idx The index of the moved point
+     * @param displacement The displacement of the point
+     */
+    void move(std::size_t idx, const Point& displacement);
 
     /**
      * Makes the curve based on the stored control points.
      */
     void make();
 
+    /// the number of displacements applied to the curve points before computing them again from scratch, to bound
+    /// the accumulation of rounding errors
+    static constexpr std::size_t maxDisplacements{64};
+
     /// the number of steps for t
     std::size_t steps;
+    /// the way the curve is sampled
+    Tessellation tessellation{Tessellation::Uniform};
+    /// the distance tolerance for the adaptive tessellation
+    double tolerance{.25};
+    /// the number of displacements applied since the curve points were last computed from scratch
+    std::size_t displacements{0};
     /// the array of control points
     //std::vector<Point> controlPoints;
     /// the array of the actual curvePoints
     std::vector<Point> curvePoints;
+    /// the t values of the curve points
+    std::vector<double> parameters;
+    /// the curve of the control points but the first one, used when adding a point
+    std::vector<Point> tailPoints;
+    /// the working memory of the deCasteljau's algorithm
+    std::vector<Point> workspace;
+    /// the Bernstein polynomials for the current degree, shared with the other curves
+    std::shared_ptr<const BernsteinBasis> basis;
+    /// the coordinates of the control points, padded for the product with the Bernstein basis
+    std::vector<double> xCoordinates;
+    std::vector<double> yCoordinates;
 };
@@ -0,0 +1,166 @@
+#include "ChebycheffSeries.h"
+
+#include "Tracer.h"
+
+#include <cassert>
+#include <utility>
+
+#include <glm/ext/scalar_constants.hpp>
+
+void ChebycheffSeries::build(Span<const double> X, Span<const double> Y)
+{
+    CURVES_TRACE_SCOPE("ChebycheffSeries::build");
+    assert(X.size() == Y.size());
+    const auto n = X.size();
+    coefficients.resize(n);
+    if(n == 0)
+    {
+        return;
+    }
+    plan(n);
+    // Makhoul's reordering, the even points forward then the odd ones backward, turns the cosine transform into a
+    // Fourier transform of the same length, and the x and y coordinates are transformed at once as the real and
+    // imaginary parts of a single sequence
+    buffer.resize(n);
+    for(std::size_t i{0}; i < n; ++i)
+    {
+        buffer[i % 2 == 0 ? i / 2 : n - 1 - i / 2] = {X[i], Y[i]};
+    }
+    fourier(buffer);
+    const auto inverseSize = 1. / static_cast<double>(n);
+    for(std::size_t k{0}; k < n; ++k)
+    {
+        // the transforms of the real and imaginary parts from the hermitian symmetry of real transforms
+        const auto mirror = std::conj(buffer[(n - k) % n]);
+        const auto x = (buffer[k] + mirror) * .5;
+        const auto y = (buffer[k] - mirror) * Complex(0, -.5);
+        const auto scale = (k == 0 ? 1. : 2.) * inverseSize;
+        coefficients[k] = Point{(shifts[k] * x).real(), (shifts[k] * y).real()} * scale;
+    }
+}
+
+Point ChebycheffSeries::operator()(double t) const
+{
+    assert(!coefficients.empty());
+    Point next{0, 0};
+    Point afterNext{0, 0};
+    for(auto k = coefficients.size() - 1; k > 0; --k)
+    {
+        const auto current = coefficients[k] + 2. * t * next - afterNext;
+        afterNext = next;
+        next = current;
+    }
+    return coefficients[0] + t * next - afterNext;
+}
+
+void ChebycheffSeries::plan(std::size_t n)
+{
+    if(planned == n)
+    {
+        return;
+    }
+    planned = n;
+    const auto pi = glm::pi<double>();
+    const auto powerOfTwo = (n & (n - 1)) == 0;
+    // Bluestein's algorithm computes a transform of any length as a convolution of length at least 2n - 1
+    std::size_t m{1};
+    while(m < (powerOfTwo ? n : 2 * n - 1))
+    {
+        m *= 2;
+    }
+    twiddles.resize(m / 2);
+    for(std::size_t k{0}; k < twiddles.size(); ++k)
+    {
+        twiddles[k] = std::polar(1., -2. * pi * static_cast<double>(k) / static_cast<double>(m));
+    }
+    shifts.resize(n);
+    for(std::size_t k{0}; k < n; ++k)
+    {
+        shifts[k] = std::polar(1., -pi * static_cast<double>(k) / static_cast<double>(2 * n));
+    }
+    if(powerOfTwo)
+    {
+        chirp.clear();
+        kernel.clear();
+        return;
+    }
+    chirp.resize(n);
+    for(std::size_t j{0}; j < n; ++j)
+    {
+        // k^2 modulo 2n keeps the angle accurate for large k
+        chirp[j] = std::polar(1., -pi * static_cast<double>(j * j % (2 * n)) / static_cast<double>(n));
+    }
+    kernel.assign(m, Complex(0, 0));
+    kernel[0] = std::conj(chirp[0]);
+    for(std::size_t j{1}; j < n; ++j)
+    {
+        kernel[j] = kernel[m - j] = std::conj(chirp[j]);
+    }
+    radix2(kernel, false);
+    // the normalization of the inverse transform of the convolution
+    for(auto& value : kernel)
+    {
+        value /= static_cast<double>(m);
+    }
+}
+
+void ChebycheffSeries::fourier(std::vector<Complex>& data)
+{
+    if(chirp.empty())
+    {
+        radix2(data, false);
+        return;
+    }
+    const auto n = data.size();
+    work.assign(kernel.size(), Complex(0, 0));
+    for(std::size_t j{0}; j < n; ++j)
+    {
+        work[j] = data[j] * chirp[j];
+    }
+    radix2(work, false);
+    for(std::size_t k{0}; k < work.size(); ++k)
+    {
+        work[k] *= kernel[k];
+    }
+    radix2(work, true);
+    for(std::size_t k{0}; k < n; ++k)
+    {
+        data[k] = chirp[k] * work[k];
+    }
+}
+
+void ChebycheffSeries::radix2(std::vector<Complex>& data, bool inverse) const
+{
+    const auto m = data.size();
+    assert(twiddles.size() * 2 == m || m == 1);
+    // the bit-reversal permutation
+    for(std::size_t i{1}, j{0}; i < m; ++i)
+    {
+        auto bit = m >> 1U;
+        for(; (j & bit) != 0; bit >>= 1U)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if(i < j)
+        {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for(std::size_t length{2}; length <= m; length *= 2)
+    {
+        const auto half = length / 2;
+        const auto stride = m / length;
+        for(std::size_t i{0}; i < m; i += length)
+        {
+            for(std::size_t k{0}; k < half; ++k)
+            {
+                const auto twiddle = inverse ? std::conj(twiddles[k * stride]) : twiddles[k * stride];
+                const auto u = data[i + k];
+                const auto v = data[i + k + half] * twiddle;
+                data[i + k] = u + v;
+                data[i + k + half] = u - v;
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Point.h"
+#include "Span.h"
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/**
+ * The Lagrange curve through points at the Chebycheff nodes cos((2i + 1) pi / 2n) of computeChebycheffSubdivision(),
+ * stored as its coefficients in the basis of the Chebycheff polynomials T_k. The coefficients are the discrete cosine
+ * transform of the points, computed with a fast Fourier transform in O(n log n), and a point of the curve is evaluated
+ * with the Clenshaw recurrence in O(n).
+ */
+class ChebycheffSeries
+{
+public:
+    /**
+     * Computes the coefficients of the curve, the working memory being reused when the number of points is unchanged.
+     * @param X The list of x coordinates of the points, the i-th point being at the i-th Chebycheff node.
+     * @param Y The list of y coordinates of the points.
+     */
+    void build(Span<const double> X, Span<const double> Y);
+
+    /**
+     * Evaluates the curve with the Clenshaw recurrence.
+     * @param t The parameter value, in [-1, 1].
+     * @return The point of the curve.
+     */
+    [[nodiscard]] Point operator()(double t) const;
+
+    [[nodiscard]] std::size_t size() const { return coefficients.size(); }
+
+    /// @return the coefficients of T_0, ..., T_n-1
+    [[nodiscard]] const std::vector<Point>& getCoefficients() const { return coefficients; }
+
+private:
+    using Complex = std::complex<double>;
+
+    /**
+     * Prepares the transforms of length n: the twiddle factors, and the chirp of Bluestein's algorithm if n is not a
+     * power of two.
+     */
+    void plan(std::size_t n);
+
+    /// computes the discrete Fourier transform of the planned length in place
+    void fourier(std::vector<Complex>& data);
+
+    /// the radix-2 transform of a power of two length, with the twiddle factors of the plan
+    void radix2(std::vector<Complex>& data, bool inverse) const;
+
+    std::vector<Point> coefficients{};
+    /// the length of the planned transforms, 0 if none
+    std::size_t planned{0};
+    /// the exp(-2 i pi k / m) of the radix-2 transforms of length m
+    std::vector<Complex> twiddles{};
+    /// the exp(-i pi k / 2n) turning the Fourier transform of the reordered points into their cosine transform
+    std::vector<Complex> shifts{};
+    /// the exp(-i pi k^2 / n) of Bluestein's algorithm, empty when n is a power of two
+    std::vector<Complex> chirp{};
+    /// the transform of the convolution kernel of Bluestein's algorithm
+    std::vector<Complex> kernel{};
+    std::vector<Complex> buffer{};
+    std::vector<Complex> work{};
+};
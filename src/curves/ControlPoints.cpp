@@ -1,41 +1,170 @@
 #include "ControlPoints.h"
 
+#include "Tracer.h"
+
 bool ControlPoints::deleteControlPoint(const Point& p, double threshold)
 {
-    return deletePoint(controlPoints, p, threshold);
+    const auto idx = ControlPoints::getIndexClosestPoint(p, threshold);
+    if(!idx.has_value())
+    {
+        return false;
+    }
+    ControlPoints::deleteControlPointAtIndex(idx.value());
+    return true;
+}
+
+void ControlPoints::deleteControlPointAtIndex(std::size_t idx)
+{
+    const auto removed = idx < controlPoints.size() ? controlPoints[idx] : Point{0, 0};
+    // throws if the index is out of bounds
+    deletePointAtIndex(controlPoints, idx);
+    grid.erase(idx, removed);
+    if(keepArrays)
+    {
+        coordinateArrays.erase(idx);
+    }
 }
 
 bool ControlPoints::updateControlPoint(const Point& p_old, const Point& p_new, double threshold)
 {
-    return updatePoint(controlPoints, p_old, p_new, threshold);
+    const auto idx = ControlPoints::getIndexClosestPoint(p_old, threshold);
+    if(!idx.has_value())
+    {
+        return false;
+    }
+    ControlPoints::updateControlPointAtIndex(idx.value(), p_new, threshold);
+    return true;
 }
 
 void ControlPoints::updateControlPointAtIndex(std::size_t idx, const Point& p_new, double)
 {
-    return updatePointAtIndex(controlPoints, idx, p_new);
+    const auto p_old = idx < controlPoints.size() ? controlPoints[idx] : p_new;
+    updatePointAtIndex(controlPoints, idx, p_new);
+    grid.move(idx, p_old, p_new);
+    if(keepArrays)
+    {
+        coordinateArrays.set(idx, p_new);
+    }
 }
 
 void ControlPoints::add(Point p)
 {
     controlPoints.push_back(p);
+    grid.insert(controlPoints.size() - 1, p);
+    if(keepArrays)
+    {
+        coordinateArrays.push_back(p);
+    }
 }
 
 void ControlPoints::reset()
 {
     controlPoints.clear();
+    grid.clear();
+    coordinateArrays.clear();
 }
 
 std::optional<Point> ControlPoints::getClosestPoint(const Point& p, double threshold) const
 {
-    return ::getClosestPoint(controlPoints, p, threshold);
+    const auto idx = getIndexClosestPoint(p, threshold);
+    if(idx.has_value())
+    {
+        return {controlPoints[idx.value()]};
+    }
+    return {};
 }
 
 std::optional<std::size_t> ControlPoints::getIndexClosestPoint(const Point& p, double threshold) const
 {
-    return ::getClosestPointIndex(controlPoints, p, threshold);
+    CURVES_TRACE_SCOPE("ControlPoints::getIndexClosestPoint");
+    return grid.closest(controlPoints, p, threshold, keepArrays ? &coordinateArrays : nullptr);
+}
+
+void ControlPoints::setSpatialIndexCellSize(double cellSize) { grid.setCellSize(cellSize, controlPoints); }
+
+void ControlPoints::keepCoordinateArrays(bool keep)
+{
+    keepArrays = keep;
+    coordinateArrays = CoordinateArrays{};
+    if(keep)
+    {
+        coordinateArrays.assign(controlPoints);
+    }
 }
 
 void ControlPoints::setControlPoints(const std::vector<Point>& ctrlPoints)
 {
     this->controlPoints = ctrlPoints;
+    grid.build(controlPoints);
+    if(keepArrays)
+    {
+        coordinateArrays.assign(controlPoints);
+    }
+}
+
+void ControlPoints::commitEdit()
+{
+    if(transactionDepth == 0 || --transactionDepth > 0)
+    {
+        return;
+    }
+    flushEdits();
+}
+
+void ControlPoints::abandonEdit() noexcept
+{
+    if(transactionDepth > 0)
+    {
+        --transactionDepth;
+    }
+}
+
+void ControlPoints::flushEdits()
+{
+    if(rebuildPending)
+    {
+        rebuildPending = false;
+        rebuild();
+    }
+    if(pendingChange.has_value())
+    {
+        const auto change = pendingChange.value();
+        pendingChange.reset();
+        notify(change);
+    }
+}
+
+void ControlPoints::requestRebuild()
+{
+    if(!deferRebuild())
+    {
+        rebuild();
+    }
+}
+
+bool ControlPoints::deferRebuild()
+{
+    if(transactionDepth > 0)
+    {
+        rebuildPending = true;
+        return true;
+    }
+    // the edits of an abandoned batch are taken into account with this one
+    if(rebuildPending)
+    {
+        rebuildPending = false;
+        rebuild();
+        return true;
+    }
+    return false;
+}
+
+void ControlPoints::publish(const CurveChange& change)
+{
+    pendingChange = pendingChange.has_value() ? pendingChange->merge(change) : change;
+    if(transactionDepth == 0)
+    {
+        // the changes of an abandoned batch are published with this one
+        flushEdits();
+    }
 }
@@ -1,12 +1,22 @@
 #pragma once
 
+#include "CoordinateArrays.h"
+#include "CurveChange.h"
 #include "Point.h"
+#include "SpatialGrid.h"
 #include "Subject.h"
 
+#include <cassert>
+#include <cstddef>
+#include <exception>
 #include <vector>
 #include <optional>
 
-class ControlPoints
+/**
+ * The control points of a curve. The curves computed from them publish a CurveChange to their observers after each
+ * modification, or once for a batch of edits when it is committed.
+ */
+class ControlPoints : public Subject<CurveChange>
 {
 public:
     ControlPoints() = default;
@@ -18,19 +28,136 @@ public:
     [[nodiscard]] virtual std::optional<std::size_t> getIndexClosestPoint(const Point& p, double threshold) const;
 
     virtual bool deleteControlPoint(const Point& p, double threshold);
+    virtual void deleteControlPointAtIndex(std::size_t idx);
 
     virtual bool updateControlPoint(const Point& p_old, const Point& p_new, double threshold);
     virtual void updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold);
 
     virtual void reset();
 
+    /**
+     * Replaces all the control points at once, which is cheaper than adding them one by one.
+     * @param ctrlPoints The new control points
+     */
+    virtual void setControlPoints(const std::vector<Point>& ctrlPoints);
+
+    /**
+     * Starts a batch of edits of the control points: the computations of the curve following each edit are deferred
+     * until the batch is committed, so that the curve is computed once for the whole batch. The batches can be nested,
+     * the curve being computed when the outermost one is committed.
+     */
+    void beginEdit() { ++transactionDepth; }
+
+    /**
+     * Ends a batch of edits started by beginEdit(), computing the curve if this is the outermost batch and the control
+     * points have been edited, then notifying the observers of the changes of the batch merged into one.
+     */
+    void commitEdit();
+
+    /**
+     * Ends a batch of edits started by beginEdit() without computing the curve nor notifying the observers, e.g. when
+     * an edit of the batch has failed. The edits already made are kept: if this is the outermost batch, the curve is
+     * computed and their changes published by the next committed batch or the next edit.
+     */
+    void abandonEdit() noexcept;
+
+    /// @return whether a batch of edits is in progress
+    [[nodiscard]] bool inTransaction() const { return transactionDepth > 0; }
+
+    /**
+     * A batch of edits of the control points, committed by commit(). If the scope is left without committing, e.g.
+     * by an exception, the batch is abandoned, so the destructor never throws.
+     */
+    class Transaction
+    {
+    public:
+        explicit Transaction(ControlPoints& p_points) : points(p_points), exceptions(std::uncaught_exceptions())
+        {
+            points.beginEdit();
+        }
+
+        ~Transaction()
+        {
+            if(!committed)
+            {
+                // leaving the scope without an exception in flight means that the commit has been forgotten
+                assert(std::uncaught_exceptions() > exceptions);
+                points.abandonEdit();
+            }
+        }
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        /**
+         * Ends the batch, see commitEdit(), the errors of the computation of the curve or of the observers being
+         * propagated. It is called once, before the end of the scope.
+         */
+        void commit()
+        {
+            assert(!committed);
+            committed = true;
+            points.commitEdit();
+        }
+
+    private:
+        ControlPoints& points;
+        /// the number of exceptions in flight when the batch started, to tell whether the scope is left by one
+        int exceptions;
+        bool committed{false};
+    };
+
     [[nodiscard]] virtual const std::vector<Point>& getControlPoints() const { return controlPoints; }
 
     virtual std::size_t size() { return controlPoints.size(); }
 
+    /**
+     * Sets the size of the cells of the grid used to find the closest point, ideally close to the usual threshold.
+     * @param cellSize The size of the cells, it must be positive
+     */
+    void setSpatialIndexCellSize(double cellSize);
+
+    /**
+     * Keeps the coordinates of the control points in separate arrays as well, in sync with the edits, for the
+     * computations working on the x and the y coordinates separately.
+     * @param keep true to keep the arrays, false to release them
+     */
+    void keepCoordinateArrays(bool keep);
+
+    [[nodiscard]] bool hasCoordinateArrays() const { return keepArrays; }
+
+    /**
+     * @return the coordinates of the control points as a structure of arrays, empty unless keepCoordinateArrays() has
+     * been enabled
+     */
+    [[nodiscard]] const CoordinateArrays& getCoordinateArrays() const { return coordinateArrays; }
+
 protected:
+    /**
+     * Called after an edit of the control points needing a full computation of the curve: computes it at once, or
+     * when the current batch of edits is committed.
+     */
+    void requestRebuild();
+
+    /**
+     * Called after an edit of the control points before updating the curve, to defer the update during a batch of
+     * edits.
+     * @return true if the curve must not be updated from the edit: a batch of edits is in progress, the curve being
+     * then computed when it is committed, or a batch has been abandoned, the curve being then computed at once
+     */
+    bool deferRebuild();
+
+    /// computes the curve from the control points, the curves computed on demand have nothing to do
+    virtual void rebuild() { }
+
+    /// computes the curve if needed and notifies the observers of the changes of the last batch of edits
+    void flushEdits();
 
-    void setControlPoints(const std::vector<Point>& ctrlPoints);
+    /**
+     * Notifies the observers of a change of the curve, or merges it into the changes of the current batch of edits.
+     * @param change The change
+     */
+    void publish(const CurveChange& change);
 
 //    using iterator = std::vector<Point>::iterator;
 //    using const_iterator = std::vector<Point>::const_iterator;
@@ -45,4 +172,15 @@ protected:
 
 private:
     std::vector<Point> controlPoints;
+    /// the spatial index of the control points, kept in sync with them
+    SpatialGrid grid;
+    /// the coordinates of the control points, kept in sync with them if keepArrays is set
+    CoordinateArrays coordinateArrays;
+    bool keepArrays{false};
+    /// the number of nested batches of edits in progress
+    std::size_t transactionDepth{0};
+    /// whether the curve must be computed when the outermost batch of edits is committed
+    bool rebuildPending{false};
+    /// the changes of the current batch of edits, published when it is committed
+    std::optional<CurveChange> pendingChange{};
 };
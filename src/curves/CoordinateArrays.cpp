@@ -0,0 +1,155 @@
+#include "CoordinateArrays.h"
+
+#include "simd.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+/// the number of doubles filling a multiple of the alignment, so that the arrays can be processed by whole registers
+std::size_t alignedCapacity(std::size_t capacity)
+{
+    constexpr auto perBlock = CoordinateArrays::alignment / sizeof(double);
+    return (capacity + perBlock - 1) / perBlock * perBlock;
+}
+}
+
+CoordinateArrays::CoordinateArrays(const CoordinateArrays& other) { *this = other; }
+
+CoordinateArrays& CoordinateArrays::operator=(const CoordinateArrays& other)
+{
+    if(this != &other)
+    {
+        count = 0;
+        reserve(other.count);
+        std::copy_n(other.x.get(), other.count, x.get());
+        std::copy_n(other.y.get(), other.count, y.get());
+        count = other.count;
+    }
+    return *this;
+}
+
+CoordinateArrays::CoordinateArrays(CoordinateArrays&& other) noexcept
+    : x(std::move(other.x)),
+      y(std::move(other.y)),
+      count(std::exchange(other.count, 0)),
+      allocated(std::exchange(other.allocated, 0))
+{
+}
+
+CoordinateArrays& CoordinateArrays::operator=(CoordinateArrays&& other) noexcept
+{
+    if(this != &other)
+    {
+        x = std::move(other.x);
+        y = std::move(other.y);
+        count = std::exchange(other.count, 0);
+        allocated = std::exchange(other.allocated, 0);
+    }
+    return *this;
+}
+
+void CoordinateArrays::assign(Span<const Point> points)
+{
+    count = 0;
+    reserve(points.size());
+    for(std::size_t i{0}; i < points.size(); ++i)
+    {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+    }
+    count = points.size();
+}
+
+void CoordinateArrays::push_back(const Point& p)
+{
+    if(count == allocated)
+    {
+        reserve(std::max<std::size_t>(2 * allocated, 8));
+    }
+    x[count] = p.x;
+    y[count] = p.y;
+    ++count;
+}
+
+void CoordinateArrays::set(std::size_t idx, const Point& p)
+{
+    assert(idx < count);
+    x[idx] = p.x;
+    y[idx] = p.y;
+}
+
+void CoordinateArrays::erase(std::size_t idx)
+{
+    assert(idx < count);
+    std::copy(x.get() + idx + 1, x.get() + count, x.get() + idx);
+    std::copy(y.get() + idx + 1, y.get() + count, y.get() + idx);
+    --count;
+}
+
+std::optional<std::size_t> CoordinateArrays::closest(const Point& p, double threshold) const
+{
+    using simd::Pack;
+    static_assert(alignment % (Pack::size * sizeof(double)) == 0, "the arrays must be aligned on the registers");
+    auto closestDistance = std::numeric_limits<double>::max();
+    std::optional<std::size_t> res{};
+    const auto check = [&](std::size_t i, double dist) {
+        if(dist <= threshold && dist < closestDistance)
+        {
+            closestDistance = dist;
+            res = i;
+        }
+    };
+    const auto px = Pack::broadcast(p.x);
+    const auto py = Pack::broadcast(p.y);
+    std::size_t i{0};
+    // the arrays start on a register boundary, the whole registers are read with aligned loads and the last points
+    // one by one, the padding of the arrays being left uninitialized
+    for(; i + Pack::size <= count; i += Pack::size)
+    {
+        const auto dx = Pack::loadAligned(x.get() + i) - px;
+        const auto dy = Pack::loadAligned(y.get() + i) - py;
+        const auto dist = simd::sqrt(dx * dx + dy * dy);
+        // most registers hold no point closer than the current one
+        if(simd::lessEqualMask(dist, Pack::broadcast(std::min(threshold, closestDistance))) == 0)
+        {
+            continue;
+        }
+        std::array<double, Pack::size> lanes{};
+        dist.store(lanes.data());
+        for(std::size_t lane{0}; lane < Pack::size; ++lane)
+        {
+            check(i + lane, lanes[lane]);
+        }
+    }
+    for(; i < count; ++i)
+    {
+        const auto dx = x[i] - p.x;
+        const auto dy = y[i] - p.y;
+        check(i, std::sqrt(dx * dx + dy * dy));
+    }
+    return res;
+}
+
+void CoordinateArrays::reserve(std::size_t capacity)
+{
+    if(capacity <= allocated)
+    {
+        return;
+    }
+    const auto size = alignedCapacity(capacity);
+    const auto allocate = [size] {
+        return Array(static_cast<double*>(::operator new[](size * sizeof(double), std::align_val_t{alignment})));
+    };
+    auto newX = allocate();
+    auto newY = allocate();
+    std::copy_n(x.get(), count, newX.get());
+    std::copy_n(y.get(), count, newY.get());
+    x = std::move(newX);
+    y = std::move(newY);
+    allocated = size;
+}
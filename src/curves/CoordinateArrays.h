@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Point.h"
+#include "Span.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+
+/**
+ * The coordinates of a list of points stored as a structure of arrays: the x and the y coordinates are kept in two
+ * contiguous arrays, so that the interpolation kernels read them directly instead of splitting the points first. The
+ * arrays are aligned for the widest SIMD registers, closest() reading them with aligned loads.
+ * The arrays grow geometrically as std::vector, so keeping them in sync with the points does not allocate per edit.
+ */
+class CoordinateArrays
+{
+public:
+    /// the alignment of the arrays, in bytes
+    static constexpr std::size_t alignment{32};
+
+    CoordinateArrays() = default;
+    CoordinateArrays(const CoordinateArrays& other);
+    CoordinateArrays& operator=(const CoordinateArrays& other);
+    // the moved-from arrays are left empty and without storage, ready to be reused
+    CoordinateArrays(CoordinateArrays&& other) noexcept;
+    CoordinateArrays& operator=(CoordinateArrays&& other) noexcept;
+    ~CoordinateArrays() = default;
+
+    /**
+     * Replaces the coordinates with the ones of the given points.
+     * @param points The points
+     */
+    void assign(Span<const Point> points);
+
+    /**
+     * Adds the coordinates of a point at the end.
+     * @param p The point
+     */
+    void push_back(const Point& p);
+
+    /**
+     * Sets the coordinates of a point.
+     * @param idx The index of the point, it must be valid
+     * @param p The new point
+     */
+    void set(std::size_t idx, const Point& p);
+
+    /**
+     * Removes the coordinates of a point, the following ones are shifted by one.
+     * @param idx The index of the point, it must be valid
+     */
+    void erase(std::size_t idx);
+
+    void clear() { count = 0; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    /// @return the x coordinates of the points
+    [[nodiscard]] Span<const double> xs() const { return {x.get(), count}; }
+
+    /// @return the y coordinates of the points
+    [[nodiscard]] Span<const double> ys() const { return {y.get(), count}; }
+
+    /**
+     * Finds the closest point within the threshold, with the same result as getClosestPointIndex() on the points,
+     * the distances to several points being computed at once from aligned loads of the arrays.
+     * @param p The query point
+     * @param threshold The maximum distance from the query point
+     * @return The index of the closest point, the lowest one in case of ties, if any
+     */
+    [[nodiscard]] std::optional<std::size_t> closest(const Point& p, double threshold) const;
+
+private:
+    struct AlignedDelete
+    {
+        void operator()(double* ptr) const { ::operator delete[](ptr, std::align_val_t{alignment}); }
+    };
+    using Array = std::unique_ptr<double[], AlignedDelete>;
+
+    /**
+     * Makes room for the given number of points, keeping the current coordinates.
+     * @param capacity The number of points
+     */
+    void reserve(std::size_t capacity);
+
+    Array x{};
+    Array y{};
+    std::size_t count{0};
+    std::size_t allocated{0};
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "Span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/// the conditions closing the system of a cubic spline at its first and last nodes
+enum class SplineBoundary
+{
+    /// the second derivative is zero at both ends
+    Natural,
+    /// the first derivative is given at both ends
+    Clamped
+};
+
+/**
+ * A cubic spline interpolating values at increasing nodes, stored as its values and second derivatives (moments) at
+ * the nodes. Building it solves a tridiagonal system with the Thomas algorithm in O(n) operations, evaluating it
+ * finds the interval of the parameter in O(log n), or in O(1) with a Cursor for increasing or decreasing parameters.
+ * @tparam Value The type of the values at the nodes, e.g. double or Point
+ */
+template <typename Value>
+class CubicSpline
+{
+public:
+    using value_type = Value;
+
+    /**
+     * Evaluates the spline at close parameter values, starting the search of each interval from the previous one.
+     */
+    class Cursor
+    {
+    public:
+        /**
+         * @param p_spline The spline, it must outlive the cursor and not be modified while the cursor is used.
+         * @param t The first parameter value, used to find the starting interval.
+         */
+        explicit Cursor(const CubicSpline& p_spline, double t = 0.) : spline(&p_spline), current(p_spline.interval(t))
+        { }
+
+        [[nodiscard]] Value operator()(double t)
+        {
+            const auto& T = spline->nodes;
+            while(current + 2 < T.size() && t > T[current + 1])
+            {
+                ++current;
+            }
+            while(current > 0 && t < T[current])
+            {
+                --current;
+            }
+            return spline->evaluate(current, t);
+        }
+
+    private:
+        const CubicSpline* spline;
+        std::size_t current;
+    };
+
+    /**
+     * Builds the spline.
+     * @param T The list of nodes, they must be strictly increasing, see mergeRepeatedNodes().
+     * @param Y The list of values at the nodes.
+     * @param boundary The conditions at the ends.
+     * @param startSlope The first derivative at the first node for a clamped spline.
+     * @param endSlope The first derivative at the last node for a clamped spline.
+     * @throw std::invalid_argument if the nodes are not strictly increasing, e.g. repeated.
+     */
+    void build(Span<const double> T,
+               Span<const Value> Y,
+               SplineBoundary boundary = SplineBoundary::Natural,
+               const Value& startSlope = Value(0.),
+               const Value& endSlope = Value(0.))
+    {
+        assert(T.size() == Y.size());
+        for(std::size_t i = 1; i < T.size(); ++i)
+        {
+            // written to reject the NaNs as well
+            if(!(T[i] > T[i - 1]))
+            {
+                throw std::invalid_argument("the nodes of a cubic spline must be strictly increasing");
+            }
+        }
+        nodes.assign(T.begin(), T.end());
+        values.assign(Y.begin(), Y.end());
+        const auto n = T.size();
+        moments.assign(n, Value(0.));
+        if(n < 2)
+        {
+            return;
+        }
+        // the system is a_i M_i-1 + b_i M_i + c_i M_i+1 = d_i, the Thomas algorithm eliminates a_i going forward, the
+        // modified c_i being kept in the scratch buffer and the modified d_i in the moments
+        scratch.resize(n);
+        const auto slope = [&](std::size_t i) { return (values[i + 1] - values[i]) / (nodes[i + 1] - nodes[i]); };
+        const auto clamped = boundary == SplineBoundary::Clamped;
+        {
+            const auto h = nodes[1] - nodes[0];
+            const auto b = clamped ? 2. * h : 1.;
+            scratch[0] = (clamped ? h : 0.) / b;
+            moments[0] = clamped ? 6. * (slope(0) - startSlope) / b : Value(0.);
+        }
+        auto hPrev = nodes[1] - nodes[0];
+        auto slopePrev = slope(0);
+        for(std::size_t i = 1; i + 1 < n; ++i)
+        {
+            const auto h = nodes[i + 1] - nodes[i];
+            const auto slopeNext = slope(i);
+            // a single division on the dependency chain of the elimination
+            const auto inverse = 1. / (2. * (hPrev + h) - hPrev * scratch[i - 1]);
+            scratch[i] = h * inverse;
+            moments[i] = (6. * (slopeNext - slopePrev) - hPrev * moments[i - 1]) * inverse;
+            hPrev = h;
+            slopePrev = slopeNext;
+        }
+        {
+            const auto h = nodes[n - 1] - nodes[n - 2];
+            const auto a = clamped ? h : 0.;
+            const auto m = (clamped ? 2. * h : 1.) - a * scratch[n - 2];
+            const auto d = clamped ? 6. * (endSlope - slope(n - 2)) : Value(0.);
+            moments[n - 1] = (d - a * moments[n - 2]) / m;
+        }
+        for(std::size_t i = n - 1; i-- > 0;)
+        {
+            moments[i] = moments[i] - scratch[i] * moments[i + 1];
+        }
+    }
+
+    /**
+     * Evaluates the spline, the cubic of the first or last interval being extended outside of the nodes.
+     * @param t The value where to evaluate the spline.
+     * @return The value of the spline.
+     */
+    [[nodiscard]] Value operator()(double t) const { return evaluate(interval(t), t); }
+
+    /**
+     * @param t A parameter value.
+     * @return the index i of the interval [T_i, T_i+1] containing t, the first or the last one outside of the nodes.
+     */
+    [[nodiscard]] std::size_t interval(double t) const
+    {
+        if(nodes.size() < 2)
+        {
+            return 0;
+        }
+        const auto next = std::upper_bound(nodes.begin(), nodes.end(), t);
+        const auto idx = static_cast<std::size_t>(std::max<std::ptrdiff_t>(next - nodes.begin(), 1)) - 1;
+        return std::min(idx, nodes.size() - 2);
+    }
+
+    [[nodiscard]] std::size_t size() const { return nodes.size(); }
+
+    [[nodiscard]] const std::vector<double>& getNodes() const { return nodes; }
+
+    /// @return the second derivatives at the nodes
+    [[nodiscard]] const std::vector<Value>& getMoments() const { return moments; }
+
+private:
+    /**
+     * Evaluates the cubic of an interval.
+     * @param i The index of the interval.
+     * @param t The value where to evaluate the spline.
+     * @return The value of the spline.
+     */
+    [[nodiscard]] Value evaluate(std::size_t i, double t) const
+    {
+        assert(!nodes.empty());
+        if(nodes.size() == 1)
+        {
+            return values[0];
+        }
+        const auto h = nodes[i + 1] - nodes[i];
+        const auto a = (nodes[i + 1] - t) / h;
+        const auto b = 1. - a;
+        return a * values[i] + b * values[i + 1] +
+               ((a * a * a - a) * moments[i] + (b * b * b - b) * moments[i + 1]) * (h * h / 6.);
+    }
+
+    /// the nodes of the spline
+    std::vector<double> nodes{};
+    /// the values at the nodes
+    std::vector<Value> values{};
+    /// the second derivatives at the nodes
+    std::vector<Value> moments{};
+    /// the modified upper diagonal of the system while building the spline
+    std::vector<double> scratch{};
+};
+
+/**
+ * Removes the repeated nodes, e.g. the nodes of the duplicated consecutive points of a curve parametrized by the
+ * distance between its points, whose segments have a zero length, so that a spline can be built through the values.
+ * @tparam Value The type of the values at the nodes
+ * @param T The nondecreasing nodes, the repeated ones are removed in place
+ * @param Y The values at the nodes, the first value at a repeated node is kept
+ * @param merged Filled with the values at the remaining nodes if nodes are removed, left untouched otherwise
+ * @return the values at the remaining nodes, Y itself if no node is repeated
+ */
+template <typename Value>
+Span<const Value> mergeRepeatedNodes(std::vector<double>& T, Span<const Value> Y, std::vector<Value>& merged)
+{
+    assert(T.size() == Y.size());
+    const auto repeated = std::adjacent_find(T.begin(), T.end());
+    if(repeated == T.end())
+    {
+        return Y;
+    }
+    // the nodes up to the first repeated one are kept as they are
+    auto kept = static_cast<std::size_t>(repeated - T.begin()) + 1;
+    merged.assign(Y.begin(), Y.begin() + kept);
+    for(auto i = kept + 1; i < T.size(); ++i)
+    {
+        // written to keep the NaNs, which are rejected by the build
+        if(!(T[i] <= T[kept - 1]))
+        {
+            T[kept++] = T[i];
+            merged.push_back(Y[i]);
+        }
+    }
+    T.resize(kept);
+    return merged;
+}
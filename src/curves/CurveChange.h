@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+/**
+ * A range [begin, end) of indices.
+ */
+struct IndexRange
+{
+    std::size_t begin{0};
+    std::size_t end{0};
+
+    /// @return the range of all the indices
+    [[nodiscard]] static constexpr IndexRange all() { return {0, std::numeric_limits<std::size_t>::max()}; }
+
+    [[nodiscard]] bool empty() const { return begin >= end; }
+
+    [[nodiscard]] bool contains(std::size_t idx) const { return begin <= idx && idx < end; }
+
+    /**
+     * @param other Another range
+     * @return the smallest range containing both ranges
+     */
+    [[nodiscard]] IndexRange merge(const IndexRange& other) const
+    {
+        if(empty())
+        {
+            return other;
+        }
+        if(other.empty())
+        {
+            return *this;
+        }
+        return {std::min(begin, other.begin), std::max(end, other.end)};
+    }
+
+    bool operator==(const IndexRange& other) const { return begin == other.begin && end == other.end; }
+    bool operator!=(const IndexRange& other) const { return !(*this == other); }
+};
+
+/**
+ * A modification of the control points of a curve, published to the observers of the curve once it is taken into
+ * account, so that they can only update the parts that have changed.
+ */
+struct CurveChange
+{
+    /// the kinds of modifications
+    enum class Edit
+    {
+        /// points have been added at the end
+        Append,
+        /// points have been moved, their indices being unchanged
+        Move,
+        /// points have been removed, the following points being shifted
+        Remove,
+        /// any other modification, e.g. a new set of points or new sampling parameters
+        Any
+    };
+
+    Edit edit{Edit::Any};
+    /// the indices of the appended or moved points, or of the removed points before their removal, none if only the
+    /// sampling of the curve has changed
+    IndexRange points{IndexRange::all()};
+    /// the indices of the samples of the curve that have changed, the samples being also added or removed at the end
+    /// if the number of samples has changed
+    IndexRange samples{IndexRange::all()};
+
+    /**
+     * Combines two successive changes, e.g. the edits of a batch.
+     * @param next The change following this one
+     * @return a change covering both changes
+     */
+    [[nodiscard]] CurveChange merge(const CurveChange& next) const
+    {
+        // the indices of the appended or moved points are not shifted by the following appends or moves
+        if(edit == next.edit && (edit == Edit::Append || edit == Edit::Move))
+        {
+            return {edit, points.merge(next.points), samples.merge(next.samples)};
+        }
+        return {Edit::Any, IndexRange::all(), IndexRange::all()};
+    }
+};
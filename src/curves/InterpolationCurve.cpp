@@ -2,41 +2,157 @@
 
 #include "interpolation.h"
 #include "parametrization.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 void InterpolationCurve::add(Point p)
 {
     ControlPoints::add(p);
-    if(size() > 1)
+    invalidate(Edit::Append);
+    publish({CurveChange::Edit::Append, {size() - 1, size()}, IndexRange::all()});
+}
+
+void InterpolationCurve::invalidate(Edit edit, std::size_t idx)
+{
+    for(auto* cache : {&functionalCurve, &uniformCurve, &distanceCurve, &rootDistanceCurve, &chebycheffCurve})
     {
-        make();
+        if(!cache->dirty)
+        {
+            cache->edit = edit;
+            cache->moved = idx;
+        }
+        // the modifications still affecting a single point are moving the same point again, or moving the point
+        // that has just been appended
+        else if(!(cache->edit == Edit::Append && edit == Edit::Move && idx + 1 == size()) &&
+                !(cache->edit == Edit::Move && edit == Edit::Move && idx == cache->moved))
+        {
+            cache->edit = Edit::Any;
+        }
+        cache->dirty = true;
     }
 }
 
-void InterpolationCurve::make()
+const std::vector<Point>& InterpolationCurve::refresh(Cache& cache,
+                                                     void (InterpolationCurve::*make)(Cache&) const) const
 {
-    makeFunctional();
-    makeUniform();
-    makeDistance();
-    makeRootDistance();
-    makeChebycheff();
+    if(cache.dirty)
+    {
+        // at least two points are needed to get a curve, the makers overwrite the samples so that the storage grows
+        // geometrically from the previous size instead of being sized again from scratch
+        if(getControlPoints().size() > 1)
+        {
+            (this->*make)(cache);
+        }
+        else
+        {
+            cache.curve.clear();
+        }
+        cache.dirty = false;
+    }
+    return cache.curve;
+}
+
+const std::vector<Point>& InterpolationCurve::getFunctionalCurve() const
+{
+    return refresh(functionalCurve, &InterpolationCurve::makeFunctional);
+}
+
+const std::vector<Point>& InterpolationCurve::getUniformCurve() const
+{
+    return refresh(uniformCurve, &InterpolationCurve::makeUniform);
+}
+
+const std::vector<Point>& InterpolationCurve::getDistanceCurve() const
+{
+    return refresh(distanceCurve, &InterpolationCurve::makeDistance);
 }
-void InterpolationCurve::makeFunctional()
+
+const std::vector<Point>& InterpolationCurve::getRootDistanceCurve() const
 {
-    functionalCurve.clear();
-    functionalCurve.reserve(static_cast<std::size_t>(std::fabs(param.xmax - param.xmin) / param.step));
+    return refresh(rootDistanceCurve, &InterpolationCurve::makeRootDistance);
+}
+
+const std::vector<Point>& InterpolationCurve::getChebycheffCurve() const
+{
+    return refresh(chebycheffCurve, &InterpolationCurve::makeChebycheff);
+}
+
+void InterpolationCurve::update(unsigned curves) const
+{
+    CURVES_TRACE_SCOPE("InterpolationCurve::update");
+    using Make = void (InterpolationCurve::*)(Cache&) const;
+    const std::pair<Curves, std::pair<Cache*, Make>> all[] = {
+        {Functional, {&functionalCurve, &InterpolationCurve::makeFunctional}},
+        {Uniform, {&uniformCurve, &InterpolationCurve::makeUniform}},
+        {Distance, {&distanceCurve, &InterpolationCurve::makeDistance}},
+        {RootDistance, {&rootDistanceCurve, &InterpolationCurve::makeRootDistance}},
+        {Chebycheff, {&chebycheffCurve, &InterpolationCurve::makeChebycheff}}};
+    std::array<std::pair<Cache*, Make>, std::extent_v<decltype(all)>> outdated{};
+    std::size_t nbOutdated{0};
+    for(const auto& [flag, curve] : all)
+    {
+        if((curves & flag) != 0 && curve.first->dirty)
+        {
+            outdated[nbOutdated++] = curve;
+        }
+    }
+    // each curve only uses its own cache, so they can be computed concurrently
+    parallelFor(nbOutdated, 1, [&](std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i)
+        {
+            refresh(*outdated[i].first, outdated[i].second);
+        }
+    });
+}
+
+void InterpolationCurve::makeFunctional(Cache& cache) const
+{
+    CURVES_TRACE_SCOPE("InterpolationCurve::makeFunctional");
+    const auto& coordinates = getCoordinateArrays();
+    updatePolynomial(functionalPolynomial, coordinates.xs(), coordinates.ys(), cache);
+    if(param.sampling == Sampling::Adaptive)
+    {
+        const auto f = [this](double x) { return functionalPolynomial(x); };
+        // the polynomial has at most n - 2 extrema, starting with more intervals than that avoids missing one
+        const auto segments = std::max<std::size_t>(32, 2 * coordinates.size());
+        adaptiveFunctionSampling(
+            std::cref(f), param.xmin, param.xmax, param.viewport, param.tolerance, cache.curve, segments);
+        return;
+    }
+    cache.curve.clear();
+    // a step too small to change x would never reach the end of the range
+    if(!(param.xmin + param.step > param.xmin))
+    {
+        throw std::invalid_argument("The step of the functional curve does not advance along x");
+    }
+    cache.curve.reserve(static_cast<std::size_t>(std::fabs(param.xmax - param.xmin) / param.step));
     auto xcurr{param.xmin};
     while(xcurr <= param.xmax)
     {
-        functionalCurve.emplace_back(xcurr, lagrange(xcurr, getControlPoints()));
-        xcurr += param.step;
+        cache.curve.emplace_back(xcurr, functionalPolynomial(xcurr));
+        const auto next = xcurr + param.step;
+        if(!(next > xcurr))
+        {
+            throw std::invalid_argument("The step of the functional curve does not advance along x");
+        }
+        xcurr = next;
     }
 }
 
 bool InterpolationCurve::updateControlPoint(const Point& p_old, const Point& p_new, double threshold)
 {
-    if(ControlPoints::updateControlPoint(p_old, p_new, threshold))
+    const auto idx = getIndexClosestPoint(p_old, threshold);
+    if(idx.has_value())
     {
-        make();
+        updateControlPointAtIndex(idx.value(), p_new, threshold);
         return true;
     }
     return false;
@@ -45,7 +161,8 @@ bool InterpolationCurve::updateControlPoint(const Point& p_old, const Point& p_n
 void InterpolationCurve::updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold)
 {
     ControlPoints::updateControlPointAtIndex(idx, p_new, threshold);
-    make();
+    invalidate(Edit::Move, idx);
+    publish({CurveChange::Edit::Move, {idx, idx + 1}, IndexRange::all()});
 }
 
 std::optional<Point> InterpolationCurve::getClosestPoint(const Point& p, double threshold) const
@@ -54,61 +171,201 @@ std::optional<Point> InterpolationCurve::getClosestPoint(const Point& p, double
 }
 bool InterpolationCurve::deleteControlPoint(const Point& p, double threshold)
 {
-    if(ControlPoints::deleteControlPoint(p, threshold))
+    const auto idx = getIndexClosestPoint(p, threshold);
+    if(idx.has_value())
     {
-        if(size() > 1)
-        {
-            make();
-        }
-        else
-        {
-            clearCurves();
-        }
+        deleteControlPointAtIndex(idx.value());
         return true;
     }
     return false;
 }
 
+void InterpolationCurve::deleteControlPointAtIndex(std::size_t idx)
+{
+    ControlPoints::deleteControlPointAtIndex(idx);
+    invalidate(Edit::Any);
+    publish({CurveChange::Edit::Remove, {idx, idx + 1}, IndexRange::all()});
+}
+
 void InterpolationCurve::reset()
 {
     ControlPoints::reset();
-    clearCurves();
+    invalidate(Edit::Any);
+    publish({});
 }
 
-void InterpolationCurve::makeUniform()
+void InterpolationCurve::setControlPoints(const std::vector<Point>& ctrlPoints)
 {
-    uniformCurve.clear();
-    const auto [T, tToEval] = uniformSubdivision(size(), param.step);
-    uniformCurve = applyLagrangeSubdivision(getControlPoints(), T, tToEval);
+    ControlPoints::setControlPoints(ctrlPoints);
+    invalidate(Edit::Any);
+    publish({});
 }
 
-void InterpolationCurve::makeDistance()
+void InterpolationCurve::setParameters(const Parameters& p)
 {
-    distanceCurve.clear();
-    const auto [T, tToEval] = distanceSubdivision(param.step, getControlPoints());
-    distanceCurve = applyLagrangeSubdivision(getControlPoints(), T, tToEval);
+    param = p;
+    // the previous samples cannot be kept with another step
+    for(auto* cache : {&functionalCurve, &uniformCurve, &distanceCurve, &rootDistanceCurve, &chebycheffCurve})
+    {
+        cache->samples.clear();
+    }
+    invalidate(Edit::Any);
+    publish({CurveChange::Edit::Any, {}, IndexRange::all()});
 }
 
-void InterpolationCurve::clearCurves()
+void InterpolationCurve::sample(Cache& cache, double step, const CurveEvaluator& evaluate, bool keepPrefix) const
 {
-    functionalCurve.clear();
-    uniformCurve.clear();
-    distanceCurve.clear();
-    rootDistanceCurve.clear();
-    chebycheffCurve.clear();
+    if(param.sampling == Sampling::Adaptive)
+    {
+        adaptiveCurveSampling(evaluate,
+                              cache.nodes,
+                              param.tolerance,
+                              param.maxVertices,
+                              cache.samples,
+                              cache.curve,
+                              cache.workspace);
+        return;
+    }
+    createSamples(step, cache.nodes, cache.samples, keepPrefix);
+    evaluate(cache.samples, cache.curve);
 }
 
-void InterpolationCurve::makeRootDistance()
+void InterpolationCurve::sampleWindowed(Cache& cache, double step, bool keepPrefix) const
 {
-    rootDistanceCurve.clear();
-    const auto [T, tToEval] = rootDistanceSubdivision(param.step, getControlPoints());
-    rootDistanceCurve = applyLagrangeSubdivision(getControlPoints(), T, tToEval);
+    const auto& coordinates = getCoordinateArrays();
+    const auto evaluate = [&](const std::vector<double>& tToEval, std::vector<Point>& curve) {
+        applyWindowedLagrangeSubdivision(coordinates.xs(), coordinates.ys(), cache.nodes, param.window, tToEval, curve);
+    };
+    sample(cache, step, std::cref(evaluate), keepPrefix);
 }
 
-void InterpolationCurve::makeChebycheff()
+void InterpolationCurve::makeUniform(Cache& cache) const
 {
-    chebycheffCurve.clear();
-    //    const auto [T, tToEval] = chebycheffSubdivision(param.step, getControlPoints());
-    const auto [T, tToEval] = chebycheffSubdivision(.01, getControlPoints());
-    chebycheffCurve = applyLagrangeSubdivision(getControlPoints(), T, tToEval);
+    CURVES_TRACE_SCOPE("InterpolationCurve::makeUniform");
+    cache.nodes.resize(getControlPoints().size());
+    std::iota(cache.nodes.begin(), cache.nodes.end(), 0.);
+    if(windowed())
+    {
+        // the windows compute their own weights, the O(n^2) global ones are not needed
+        sampleWindowed(cache, param.step);
+        return;
+    }
+    updateNodes(uniformNodes, cache.nodes);
+    const auto& coordinates = getCoordinateArrays();
+    const auto evaluate = [&](const std::vector<double>& tToEval, std::vector<Point>& curve) {
+        applyBarycentricSubdivision(
+            coordinates.xs(), coordinates.ys(), uniformNodes.T, uniformNodes.weights, tToEval, curve);
+    };
+    sample(cache, param.step, std::cref(evaluate));
+}
+
+void InterpolationCurve::makeDistance(Cache& cache) const
+{
+    CURVES_TRACE_SCOPE("InterpolationCurve::makeDistance");
+    updateDistanceNodes(cache, &computeDistanceSubdivision, &updateDistanceSubdivision);
+    // the nodes always start at 0, so the samples below the previous last node are unchanged
+    if(windowed())
+    {
+        // the polynomial is not kept up to date while the curve is windowed
+        distancePolynomial.reset();
+        sampleWindowed(cache, param.step, true);
+        return;
+    }
+    updatePolynomial(distancePolynomial, cache.nodes, getControlPoints(), cache);
+    const auto evaluate = [this](const std::vector<double>& tToEval, std::vector<Point>& curve) {
+        applyNewtonSubdivision(distancePolynomial.getNodes(), distancePolynomial.getCoefficients(), tToEval, curve);
+    };
+    sample(cache, param.step, std::cref(evaluate), true);
+}
+
+void InterpolationCurve::makeRootDistance(Cache& cache) const
+{
+    CURVES_TRACE_SCOPE("InterpolationCurve::makeRootDistance");
+    updateDistanceNodes(cache, &computeRootDistanceSubdivision, &updateRootDistanceSubdivision);
+    if(windowed())
+    {
+        rootDistancePolynomial.reset();
+        sampleWindowed(cache, param.step, true);
+        return;
+    }
+    updatePolynomial(rootDistancePolynomial, cache.nodes, getControlPoints(), cache);
+    const auto evaluate = [this](const std::vector<double>& tToEval, std::vector<Point>& curve) {
+        applyNewtonSubdivision(
+            rootDistancePolynomial.getNodes(), rootDistancePolynomial.getCoefficients(), tToEval, curve);
+    };
+    sample(cache, param.step, std::cref(evaluate), true);
+}
+
+void InterpolationCurve::makeChebycheff(Cache& cache) const
+{
+    CURVES_TRACE_SCOPE("InterpolationCurve::makeChebycheff");
+    const auto& points = getControlPoints();
+    cache.nodes.resize(points.size());
+    computeChebycheffSubdivision(points, cache.nodes);
+    // the nodes are in [-1, 1], the step is given for an average interval between two nodes as for the uniform curve
+    const auto step = param.step * (cache.nodes.front() - cache.nodes.back()) / static_cast<double>(points.size() - 1);
+    if(windowed())
+    {
+        sampleWindowed(cache, step);
+        return;
+    }
+    const auto& coordinates = getCoordinateArrays();
+    chebycheffSeries.build(coordinates.xs(), coordinates.ys());
+    const auto evaluate = [this](const std::vector<double>& tToEval, std::vector<Point>& curve) {
+        applyChebycheffSubdivision(chebycheffSeries.getCoefficients(), tToEval, curve);
+    };
+    sample(cache, step, std::cref(evaluate));
+}
+
+void InterpolationCurve::updateNodes(Nodes& nodes, const std::vector<double>& T)
+{
+    // the uniform nodes only depend on the number of points, so moving a point keeps the weights
+    if(nodes.T != T)
+    {
+        nodes.T = T;
+        barycentricWeights(nodes.T, nodes.weights);
+    }
+}
+
+void InterpolationCurve::updateDistanceNodes(Cache& cache,
+                                             void (*compute)(Span<const Point>, Span<double>),
+                                             void (*updateAt)(Span<const Point>, std::size_t, Span<double>)) const
+{
+    const auto& points = getControlPoints();
+    if(cache.edit == Edit::Append && cache.nodes.size() + 1 == points.size())
+    {
+        cache.nodes.push_back(0);
+        updateAt(points, points.size() - 1, cache.nodes);
+    }
+    else if(cache.edit == Edit::Move && cache.nodes.size() == points.size() && cache.moved < points.size())
+    {
+        updateAt(points, cache.moved, cache.nodes);
+    }
+    else
+    {
+        cache.nodes.resize(points.size());
+        compute(points, cache.nodes);
+    }
+}
+
+template <typename Value>
+void InterpolationCurve::updatePolynomial(NewtonPolynomial<Value>& polynomial,
+                                          Span<const double> T,
+                                          Span<const typename NewtonPolynomial<Value>::value_type> values,
+                                          const Cache& cache)
+{
+    // appending a point or moving the last one leaves the other nodes untouched, so only the last diagonal of the
+    // divided-difference table has to be computed
+    if(cache.edit == Edit::Append && polynomial.size() + 1 == T.size())
+    {
+        polynomial.append(T.back(), values.back());
+    }
+    else if(cache.edit == Edit::Move && cache.moved + 1 == T.size() && polynomial.size() == T.size())
+    {
+        polynomial.updateLast(T.back(), values.back());
+    }
+    else
+    {
+        polynomial.build(T, values);
+    }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "Point.h"
+#include "ChebycheffSeries.h"
 #include "ControlPoints.h"
+#include "NewtonPolynomial.h"
+#include "sampling.h"
+#include "Span.h"
 
 #include <vector>
 #include <optional>
@@ -9,17 +13,51 @@
 class InterpolationCurve : public ControlPoints
 {
 public:
+    /// the ways of choosing the points of the curves
+    enum class Sampling
+    {
+        /// a point at every step of the parameter
+        Step,
+        /// as many points as needed to stay within a distance tolerance from the curve, see adaptiveCurveSampling()
+        /// and adaptiveFunctionSampling()
+        Adaptive
+    };
+
     struct Parameters
     {
         Parameters() = default;
-        Parameters(double x_min, double x_max, double p_step) : xmin(x_min), xmax(x_max), step(p_step) { }
+        Parameters(double x_min, double x_max, double p_step, std::size_t p_window = 0)
+            : xmin(x_min), xmax(x_max), step(p_step), window(p_window)
+        { }
         double xmin{0};
         double xmax{100};
         double step{0.1};
+        /// the number of nodes closest to each sample used to evaluate the parametric curves, all of them if 0 (see
+        /// applyWindowedLagrangeSubdivision()), the functional curve always uses all the points
+        std::size_t window{0};
+        Sampling sampling{Sampling::Step};
+        /// the maximum distance between the curves and their adaptive sampling, e.g. in pixels
+        double tolerance{.25};
+        /// the maximum number of points of a parametric curve with the adaptive sampling
+        std::size_t maxVertices{4096};
+        /// the visible part of the plane, the adaptive sampling of the functional curve stops at its bounds
+        Viewport viewport{};
     };
 
-    explicit InterpolationCurve() = default;
-    explicit InterpolationCurve(const Parameters& p) : param(p) { }
+    /// the curves computed from the control points, to be combined as flags
+    enum Curves : unsigned
+    {
+        Functional = 1U << 0U,
+        Uniform = 1U << 1U,
+        Distance = 1U << 2U,
+        RootDistance = 1U << 3U,
+        Chebycheff = 1U << 4U,
+        AllCurves = Functional | Uniform | Distance | RootDistance | Chebycheff
+    };
+
+    // the interpolations read the coordinates of the points separately
+    explicit InterpolationCurve() { keepCoordinateArrays(true); }
+    explicit InterpolationCurve(const Parameters& p) : param(p) { keepCoordinateArrays(true); }
     ~InterpolationCurve() override = default;
 
     void add(Point p) override;
@@ -28,35 +66,160 @@ public:
     std::optional<Point> getClosestPoint(const Point& p, double threshold) const override;
 
     bool deleteControlPoint(const Point& p, double threshold) override;
+    void deleteControlPointAtIndex(std::size_t idx) override;
 
     bool updateControlPoint(const Point& p_old, const Point& p_new, double threshold) override;
     void updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold) override;
 
     void reset() override;
 
-    [[nodiscard]] const auto& getFunctionalCurve() const { return functionalCurve;}
-    [[nodiscard]] const auto& getUniformCurve() const { return uniformCurve;}
-    [[nodiscard]] const auto& getDistanceCurve() const { return distanceCurve;}
-    [[nodiscard]] const auto& getRootDistanceCurve() const { return rootDistanceCurve;}
-    [[nodiscard]] const auto& getChebycheffCurve() const { return chebycheffCurve;}
+    void setControlPoints(const std::vector<Point>& ctrlPoints) override;
+
+    /**
+     * Sets the parameters of the curves, they are computed again when they are next requested.
+     * @param p The new parameters
+     */
+    void setParameters(const Parameters& p);
+
+    [[nodiscard]] const Parameters& getParameters() const { return param; }
+
+    /*
+     * The curves are computed on demand: a modification of the control points only marks them as outdated, and
+     * each curve is computed again the first time it is requested afterwards.
+     * @throw std::invalid_argument for the functional curve if its step does not advance along x, e.g. a positive
+     * step too small for the range, the curve being computed again on the next request
+     */
+    [[nodiscard]] const std::vector<Point>& getFunctionalCurve() const;
+    [[nodiscard]] const std::vector<Point>& getUniformCurve() const;
+    [[nodiscard]] const std::vector<Point>& getDistanceCurve() const;
+    [[nodiscard]] const std::vector<Point>& getRootDistanceCurve() const;
+    [[nodiscard]] const std::vector<Point>& getChebycheffCurve() const;
+
+    /**
+     * Computes the given curves if they are outdated, concurrently when the library is built with a thread pool.
+     * @param curves The curves to compute, as a combination of Curves flags
+     */
+    void update(unsigned curves = AllCurves) const;
 
 private:
-    void make();
+    /// the kind of modification of the control points that triggers a new computation of the curves
+    enum class Edit
+    {
+        /// a point has been added at the end
+        Append,
+        /// a single point has been moved, possibly several times
+        Move,
+        /// any other modification
+        Any
+    };
 
-    void makeFunctional();
-    void makeUniform();
-    void makeDistance();
-    void makeRootDistance();
-    void makeChebycheff();
+    /// a curve computed on demand, together with the modifications of the control points since its computation
+    struct Cache
+    {
+        std::vector<Point> curve{};
+        bool dirty{false};
+        Edit edit{Edit::Any};
+        /// the index of the moved point for Edit::Move
+        std::size_t moved{0};
+        /// the working memory of the computation, kept so that computing the curve again does not allocate
+        std::vector<double> nodes{};
+        std::vector<double> samples{};
+        CurveSamplingWorkspace workspace{};
+    };
 
-    void clearCurves();
+    /**
+     * Marks all the curves as outdated.
+     * @param edit The modification of the control points
+     * @param idx The index of the moved point for Edit::Move
+     */
+    void invalidate(Edit edit, std::size_t idx = 0);
+
+    /**
+     * Returns the curve of the given cache, computing it again if it is outdated.
+     * @param cache The cache of the curve
+     * @param make The method computing the curve
+     * @return the up-to-date curve
+     */
+    const std::vector<Point>& refresh(Cache& cache, void (InterpolationCurve::*make)(Cache&) const) const;
+
+    /**
+     * Samples a parametric curve from the nodes of its cache, with the policy of the parameters.
+     * @param cache The cache of the curve, holding its nodes
+     * @param step The step between two parameter values for Sampling::Step
+     * @param evaluate The evaluation of the curve
+     * @param keepPrefix Whether the previous parameter values below the previous last node are kept for
+     * Sampling::Step, see createSamples()
+     */
+    void sample(Cache& cache, double step, const CurveEvaluator& evaluate, bool keepPrefix = false) const;
+
+    /**
+     * Samples a parametric curve evaluated with a window of nodes, see applyWindowedLagrangeSubdivision().
+     */
+    void sampleWindowed(Cache& cache, double step, bool keepPrefix = false) const;
+
+    void makeFunctional(Cache& cache) const;
+    void makeUniform(Cache& cache) const;
+    void makeDistance(Cache& cache) const;
+    void makeRootDistance(Cache& cache) const;
+    void makeChebycheff(Cache& cache) const;
+
+    /// The nodes of an interpolation together with their barycentric weights
+    struct Nodes
+    {
+        std::vector<double> T{};
+        std::vector<double> weights{};
+    };
 
-    std::vector<Point> functionalCurve{};
-    std::vector<Point> uniformCurve{};
-    std::vector<Point> distanceCurve{};
-    std::vector<Point> rootDistanceCurve{};
-    std::vector<Point> chebycheffCurve{};
+    /**
+     * Updates the given nodes, the barycentric weights are recomputed only if the nodes have changed.
+     * @param nodes The cached nodes and weights to update
+     * @param T The new nodes
+     */
+    static void updateNodes(Nodes& nodes, const std::vector<double>& T);
+
+    /**
+     * Updates the Newton form of an interpolation, incrementally when the edit only affects the last node.
+     * @param polynomial The polynomial to update
+     * @param T The new nodes
+     * @param values The new values at the nodes
+     * @param cache The cache of the curve, giving the modification of the control points since the last update of
+     * the polynomial
+     */
+    template <typename Value>
+    static void updatePolynomial(NewtonPolynomial<Value>& polynomial,
+                                 Span<const double> T,
+                                 Span<const typename NewtonPolynomial<Value>::value_type> values,
+                                 const Cache& cache);
+
+    /**
+     * Updates the nodes of a curve parametrized by the distances between the points: when a single point has been
+     * appended or moved, only the nodes from this point on are updated, otherwise they are all computed again.
+     * @param cache The cache of the curve, holding the nodes of the previous computation
+     * @param compute The function computing all the nodes
+     * @param updateAt The function updating the nodes after the modification of a single point
+     */
+    void updateDistanceNodes(Cache& cache,
+                             void (*compute)(Span<const Point>, Span<double>),
+                             void (*updateAt)(Span<const Point>, std::size_t, Span<double>)) const;
+
+    /// @return whether the parametric curves are evaluated with a window of nodes smaller than the number of points
+    [[nodiscard]] bool windowed() const { return param.window > 0 && param.window < getControlPoints().size(); }
+
+    mutable Cache functionalCurve{};
+    mutable Cache uniformCurve{};
+    mutable Cache distanceCurve{};
+    mutable Cache rootDistanceCurve{};
+    mutable Cache chebycheffCurve{};
     Parameters param{};
+
+    /// the cached nodes and weights of the uniform interpolation, they only depend on the number of points
+    mutable Nodes uniformNodes{};
+    /// the coefficients of the Chebycheff interpolation in the basis of the Chebycheff polynomials
+    mutable ChebycheffSeries chebycheffSeries{};
+    /// the Newton form of the interpolations whose nodes depend on the position of the points
+    mutable NewtonPolynomial<double> functionalPolynomial{};
+    mutable NewtonPolynomial<Point> distancePolynomial{};
+    mutable NewtonPolynomial<Point> rootDistancePolynomial{};
 };
 
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Span.h"
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * The Newton form of the Lagrange polynomial passing through a set of nodes and values.
+ * The coefficients are the divided differences f[T_0], f[T_0, T_1], ..., f[T_0, ..., T_n-1], and the last two rows
+ * of the divided-difference table are kept so that a node can be appended, or the last node can be modified, in
+ * O(n) operations instead of rebuilding the whole table in O(n^2).
+ * @tparam Value The type of the values at the nodes, e.g. double or Point
+ */
+template <typename Value>
+class NewtonPolynomial
+{
+public:
+    using value_type = Value;
+
+    /**
+     * Builds the polynomial from scratch.
+     * @param T The list of nodes, they must be distinct.
+     * @param values The list of values at the nodes.
+     */
+    void build(Span<const double> T, Span<const Value> values)
+    {
+        assert(T.size() == values.size());
+        reset();
+        nodes.reserve(T.size());
+        coefficients.reserve(T.size());
+        for(std::size_t i = 0; i < T.size(); ++i)
+        {
+            append(T[i], values[i]);
+        }
+    }
+
+    void build(const std::vector<double>& T, const std::vector<Value>& values)
+    {
+        build(Span<const double>(T), Span<const Value>(values));
+    }
+
+    /**
+     * Adds a new node at the end of the polynomial.
+     * @param t The new node, it must be different from the other nodes.
+     * @param value The value at the new node.
+     */
+    void append(double t, const Value& value)
+    {
+        std::swap(previousRow, lastRow);
+        nodes.push_back(t);
+        computeLastRow(value);
+        coefficients.push_back(lastRow.back());
+    }
+
+    /**
+     * Modifies the last node of the polynomial, only the last diagonal of the table is recomputed.
+     * @param t The new value of the last node.
+     * @param value The value at the last node.
+     */
+    void updateLast(double t, const Value& value)
+    {
+        assert(!nodes.empty());
+        nodes.back() = t;
+        computeLastRow(value);
+        coefficients.back() = lastRow.back();
+    }
+
+    /**
+     * Removes all the nodes.
+     */
+    void reset()
+    {
+        nodes.clear();
+        coefficients.clear();
+        lastRow.clear();
+        previousRow.clear();
+    }
+
+    /**
+     * Evaluates the polynomial with the Horner scheme in O(n).
+     * @param t The value where to evaluate the polynomial.
+     * @return The value of the polynomial.
+     */
+    [[nodiscard]] Value operator()(double t) const
+    {
+        assert(!coefficients.empty());
+        auto res = coefficients.back();
+        for(std::size_t k = coefficients.size() - 1; k > 0; --k)
+        {
+            res = res * (t - nodes[k - 1]) + coefficients[k - 1];
+        }
+        return res;
+    }
+
+    [[nodiscard]] std::size_t size() const { return nodes.size(); }
+
+    [[nodiscard]] const std::vector<double>& getNodes() const { return nodes; }
+
+    [[nodiscard]] const std::vector<Value>& getCoefficients() const { return coefficients; }
+
+private:
+    /**
+     * Computes the divided differences f[T_n-1-k, ..., T_n-1] for the last node from the ones of the previous node.
+     * @param value The value at the last node.
+     */
+    void computeLastRow(const Value& value)
+    {
+        const auto last = nodes.size() - 1;
+        lastRow.resize(nodes.size());
+        lastRow[0] = value;
+        for(std::size_t k = 1; k <= last; ++k)
+        {
+            lastRow[k] = (lastRow[k - 1] - previousRow[k - 1]) / (nodes[last] - nodes[last - k]);
+        }
+    }
+
+    /// the nodes of the polynomial
+    std::vector<double> nodes{};
+    /// the coefficients of the Newton form
+    std::vector<Value> coefficients{};
+    /// the divided differences ending at the last node
+    std::vector<Value> lastRow{};
+    /// the divided differences ending at the node before the last one
+    std::vector<Value> previousRow{};
+};
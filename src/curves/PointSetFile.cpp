@@ -0,0 +1,296 @@
+#include "PointSetFile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+/// the first bytes of a point-set file
+constexpr char magic[8]{'C', 'U', 'R', 'V', 'E', 'P', 'T', 'S'};
+/// the version of the format
+constexpr std::uint16_t version{1};
+/// read as another value on a machine with another byte order
+constexpr std::uint32_t byteOrderMark{0x01020304};
+/// the alignment of the arrays of points
+constexpr std::size_t dataAlignment{16};
+
+struct Header
+{
+    char magic[8];
+    std::uint16_t version;
+    PointSetScalar scalar;
+    std::uint32_t byteOrder;
+    std::uint64_t count;
+    std::uint64_t indexOffset;
+};
+static_assert(sizeof(Header) == 32, "the header must not be padded");
+static_assert(sizeof(PointSetEntry) == 24, "the index entries must not be padded");
+static_assert(sizeof(Point) == 2 * sizeof(double) && sizeof(glm::vec2) == 2 * sizeof(float),
+              "the points must be packed pairs of coordinates");
+
+std::size_t pointSize(PointSetScalar scalar)
+{
+    return scalar == PointSetScalar::Float64 ? sizeof(Point) : sizeof(glm::vec2);
+}
+}
+
+PointSetFile::PointSetFile(const std::string& filename)
+{
+#ifdef _WIN32
+    file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        file = nullptr;
+        throw std::runtime_error("Cannot open " + filename);
+    }
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot read the size of " + filename);
+    }
+    mappingSize = static_cast<std::size_t>(fileSize.QuadPart);
+    if(mappingSize != 0)
+    {
+        mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mappingHandle != nullptr)
+        {
+            mapping = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+        if(mapping == nullptr)
+        {
+            if(mappingHandle != nullptr)
+            {
+                CloseHandle(mappingHandle);
+            }
+            CloseHandle(file);
+            throw std::runtime_error("Cannot map " + filename);
+        }
+    }
+#else
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        throw std::runtime_error("Cannot open " + filename);
+    }
+    struct stat status{};
+    if(::fstat(fd, &status) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot read the size of " + filename);
+    }
+    mappingSize = static_cast<std::size_t>(status.st_size);
+    if(mappingSize != 0)
+    {
+        void* address = ::mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(address == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + filename);
+        }
+        mapping = static_cast<const unsigned char*>(address);
+    }
+    // the mapping stays valid once the file is closed
+    ::close(fd);
+#endif
+
+    Header header{};
+    if(mappingSize < sizeof(Header))
+    {
+        unmap();
+        throw std::runtime_error(filename + " is not a point-set file");
+    }
+    std::memcpy(&header, mapping, sizeof(Header));
+    const auto entriesSize = header.count * sizeof(PointSetEntry);
+    const bool valid = std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version &&
+                       header.byteOrder == byteOrderMark &&
+                       (header.scalar == PointSetScalar::Float64 || header.scalar == PointSetScalar::Float32) &&
+                       header.indexOffset % alignof(PointSetEntry) == 0 && header.indexOffset <= mappingSize &&
+                       header.count <= mappingSize / sizeof(PointSetEntry) &&
+                       entriesSize <= mappingSize - header.indexOffset;
+    if(!valid)
+    {
+        unmap();
+        throw std::runtime_error(filename + " is not a valid point-set file");
+    }
+    scalar = header.scalar;
+    count = static_cast<std::size_t>(header.count);
+    index = reinterpret_cast<const PointSetEntry*>(mapping + header.indexOffset);
+}
+
+PointSetFile::~PointSetFile() { unmap(); }
+
+void PointSetFile::unmap()
+{
+#ifdef _WIN32
+    if(mapping != nullptr)
+    {
+        UnmapViewOfFile(mapping);
+        CloseHandle(mappingHandle);
+    }
+    if(file != nullptr)
+    {
+        CloseHandle(file);
+    }
+    file = nullptr;
+#else
+    if(mapping != nullptr)
+    {
+        ::munmap(const_cast<unsigned char*>(mapping), mappingSize);
+    }
+#endif
+    mapping = nullptr;
+}
+
+const PointSetEntry& PointSetFile::entry(std::size_t idx) const
+{
+    if(idx >= count)
+    {
+        throw std::out_of_range("Index of the point set is out of bounds");
+    }
+    return index[idx];
+}
+
+const void* PointSetFile::data(const PointSetEntry& e, PointSetScalar expected) const
+{
+    if(scalar != expected)
+    {
+        throw std::runtime_error("The point-set file does not store this type of coordinates");
+    }
+    // the points must be aligned and inside the file
+    const auto size = pointSize(scalar);
+    if(e.offset % dataAlignment != 0 || e.offset > mappingSize || e.size > (mappingSize - e.offset) / size)
+    {
+        throw std::runtime_error("The point-set file is corrupted");
+    }
+    return mapping + e.offset;
+}
+
+Span<const Point> PointSetFile::points(std::size_t idx) const
+{
+    const auto& e = entry(idx);
+    return {static_cast<const Point*>(data(e, PointSetScalar::Float64)), static_cast<std::size_t>(e.size)};
+}
+
+Span<const glm::vec2> PointSetFile::floatPoints(std::size_t idx) const
+{
+    const auto& e = entry(idx);
+    return {static_cast<const glm::vec2*>(data(e, PointSetScalar::Float32)), static_cast<std::size_t>(e.size)};
+}
+
+std::uint64_t PointSetFile::tag(std::size_t idx) const { return entry(idx).tag; }
+
+void PointSetFile::read(std::size_t idx, std::vector<Point>& out) const
+{
+    if(scalar == PointSetScalar::Float64)
+    {
+        const auto values = points(idx);
+        out.assign(values.begin(), values.end());
+        return;
+    }
+    const auto values = floatPoints(idx);
+    out.resize(values.size());
+    for(std::size_t i{0}; i < values.size(); ++i)
+    {
+        out[i] = Point(values[i]);
+    }
+}
+
+PointSetWriter::PointSetWriter(const std::string& filename, PointSetScalar p_scalar)
+    : file(filename, std::ios::binary | std::ios::trunc), scalar(p_scalar)
+{
+    if(!file)
+    {
+        throw std::runtime_error("Cannot create " + filename);
+    }
+    // the header is written once the index table is known
+    const Header header{};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    position = sizeof(Header);
+}
+
+PointSetWriter::~PointSetWriter()
+{
+    if(!finished)
+    {
+        try
+        {
+            finish();
+        }
+        catch(const std::exception&)
+        {
+            // nothing can be reported from a destructor, finish() must be called to know whether the file is valid
+        }
+    }
+}
+
+void PointSetWriter::write(Span<const Point> points, std::uint64_t tag)
+{
+    if(finished)
+    {
+        throw std::logic_error("The point-set file is already finished");
+    }
+    pad(dataAlignment);
+    entries.push_back({position, points.size(), tag});
+    if(scalar == PointSetScalar::Float64)
+    {
+        file.write(reinterpret_cast<const char*>(points.data()),
+                   static_cast<std::streamsize>(points.size() * sizeof(Point)));
+        position += points.size() * sizeof(Point);
+        return;
+    }
+    floats.resize(points.size());
+    for(std::size_t i{0}; i < points.size(); ++i)
+    {
+        floats[i] = glm::vec2(points[i]);
+    }
+    file.write(reinterpret_cast<const char*>(floats.data()),
+               static_cast<std::streamsize>(floats.size() * sizeof(glm::vec2)));
+    position += floats.size() * sizeof(glm::vec2);
+}
+
+void PointSetWriter::finish()
+{
+    if(finished)
+    {
+        return;
+    }
+    finished = true;
+    pad(alignof(PointSetEntry));
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.scalar = scalar;
+    header.byteOrder = byteOrderMark;
+    header.count = entries.size();
+    header.indexOffset = position;
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(PointSetEntry)));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.close();
+    if(!file)
+    {
+        throw std::runtime_error("Error while writing the point-set file");
+    }
+}
+
+void PointSetWriter::pad(std::size_t alignment)
+{
+    static constexpr char zeros[dataAlignment]{};
+    const auto padding = (alignment - position % alignment) % alignment;
+    file.write(zeros, static_cast<std::streamsize>(padding));
+    position += padding;
+}
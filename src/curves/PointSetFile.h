@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Point.h"
+#include "Span.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * A binary container of point sets, e.g. control polygons or sampled curves, made of
+ * - a header giving the type of the coordinates, the number of sets and the position of the index table,
+ * - the points of each set, packed as pairs of coordinates (glm::dvec2 or glm::vec2) aligned on 16 bytes,
+ * - the index table, giving for each set the position of its points, their number and a tag free to the application.
+ * All the values are stored in the byte order of the machine that wrote the file, which is checked when reading it.
+ */
+
+/// the type of the coordinates of the points of a point-set file
+enum class PointSetScalar : std::uint16_t
+{
+    /// glm::dvec2, i.e. Point
+    Float64 = 0,
+    /// glm::vec2
+    Float32 = 1
+};
+
+/// an entry of the index table of a point-set file
+struct PointSetEntry
+{
+    /// the position of the points in the file, in bytes
+    std::uint64_t offset;
+    /// the number of points
+    std::uint64_t size;
+    /// a value free to the application
+    std::uint64_t tag;
+};
+
+/**
+ * A read-only point-set file mapped in memory: opening it only reads its header, and the points are accessed through
+ * views on the mapped pages, so they are loaded by the system when they are first accessed, without any copy.
+ */
+class PointSetFile
+{
+public:
+    /**
+     * Maps the file in memory.
+     * @param filename The path of the file
+     * @throw std::runtime_error if the file cannot be mapped or is not a valid point-set file
+     */
+    explicit PointSetFile(const std::string& filename);
+    ~PointSetFile();
+
+    PointSetFile(const PointSetFile&) = delete;
+    PointSetFile& operator=(const PointSetFile&) = delete;
+
+    /// @return the number of point sets
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] PointSetScalar getScalar() const { return scalar; }
+
+    /**
+     * @param idx The index of the set
+     * @return the points of the set, the file must store glm::dvec2 coordinates
+     * @throw std::out_of_range if the index is not valid, std::runtime_error if the file is corrupted or stores floats
+     */
+    [[nodiscard]] Span<const Point> points(std::size_t idx) const;
+
+    /**
+     * @param idx The index of the set
+     * @return the points of the set, the file must store glm::vec2 coordinates
+     * @throw std::out_of_range if the index is not valid, std::runtime_error if the file is corrupted or stores doubles
+     */
+    [[nodiscard]] Span<const glm::vec2> floatPoints(std::size_t idx) const;
+
+    /**
+     * @param idx The index of the set
+     * @return the tag of the set given when writing it
+     */
+    [[nodiscard]] std::uint64_t tag(std::size_t idx) const;
+
+    /**
+     * Copies the points of a set, converting them to Point if needed.
+     * @param idx The index of the set
+     * @param out The points of the set
+     */
+    void read(std::size_t idx, std::vector<Point>& out) const;
+
+private:
+    void unmap();
+
+    [[nodiscard]] const PointSetEntry& entry(std::size_t idx) const;
+
+    /// @return the address of the points of the set, after checking that they are in the file
+    [[nodiscard]] const void* data(const PointSetEntry& e, PointSetScalar expected) const;
+
+    /// the mapped file
+    const unsigned char* mapping{nullptr};
+    std::size_t mappingSize{0};
+#ifdef _WIN32
+    void* file{nullptr};
+    void* mappingHandle{nullptr};
+#endif
+    PointSetScalar scalar{PointSetScalar::Float64};
+    std::size_t count{0};
+    const PointSetEntry* index{nullptr};
+};
+
+/**
+ * Writes a point-set file one set at a time, so that the sets do not need to be kept in memory.
+ */
+class PointSetWriter
+{
+public:
+    /**
+     * Creates the file.
+     * @param filename The path of the file
+     * @param p_scalar The type of the stored coordinates, the points are converted if needed
+     * @throw std::runtime_error if the file cannot be created
+     */
+    explicit PointSetWriter(const std::string& filename, PointSetScalar p_scalar = PointSetScalar::Float64);
+
+    /// finishes the file if finish() was not called
+    ~PointSetWriter();
+
+    PointSetWriter(const PointSetWriter&) = delete;
+    PointSetWriter& operator=(const PointSetWriter&) = delete;
+
+    /**
+     * Appends a point set.
+     * @param points The points of the set
+     * @param tag A value associated to the set, e.g. its kind or the index of the set it was computed from
+     */
+    void write(Span<const Point> points, std::uint64_t tag = 0);
+
+    /**
+     * Writes the index table and the header, no set can be written afterwards.
+     * @throw std::runtime_error if the file could not be written
+     */
+    void finish();
+
+    /// @return the number of sets written so far
+    [[nodiscard]] std::size_t size() const { return entries.size(); }
+
+private:
+    /// writes zeros up to the next multiple of the alignment
+    void pad(std::size_t alignment);
+
+    std::ofstream file;
+    PointSetScalar scalar;
+    /// the index table
+    std::vector<PointSetEntry> entries;
+    /// the position of the next byte to write
+    std::uint64_t position{0};
+    /// the points of the set being written, converted to floats
+    std::vector<glm::vec2> floats;
+    bool finished{false};
+};
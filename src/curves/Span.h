@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A non-owning view over a contiguous sequence of elements, a minimal replacement of the C++20 std::span.
+ * It can be built from any container exposing data() and size(), such as std::vector or std::array, so the functions
+ * taking spans can be used on memory owned by the caller without copying it.
+ * @tparam T The type of the elements, const for a read-only view
+ */
+template <typename T>
+class Span
+{
+public:
+    constexpr Span() = default;
+
+    constexpr Span(T* data, std::size_t size) : ptr(data), count(size) { }
+
+    template <typename Container,
+              typename = std::enable_if_t<!std::is_same_v<std::remove_const_t<Container>, Span> &&
+                                          std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>>>
+    constexpr Span(Container& container) : ptr(container.data()), count(container.size())
+    { }
+
+    [[nodiscard]] constexpr T* data() const { return ptr; }
+    [[nodiscard]] constexpr std::size_t size() const { return count; }
+    [[nodiscard]] constexpr bool empty() const { return count == 0; }
+
+    [[nodiscard]] constexpr T* begin() const { return ptr; }
+    [[nodiscard]] constexpr T* end() const { return ptr + count; }
+
+    [[nodiscard]] constexpr T& operator[](std::size_t idx) const
+    {
+        assert(idx < count);
+        return ptr[idx];
+    }
+
+    [[nodiscard]] constexpr T& front() const { return (*this)[0]; }
+    [[nodiscard]] constexpr T& back() const { return (*this)[count - 1]; }
+
+    /**
+     * @param offset The index of the first element of the view
+     * @param size The number of elements of the view
+     * @return the view over the elements [offset, offset + size)
+     */
+    [[nodiscard]] constexpr Span subspan(std::size_t offset, std::size_t size) const
+    {
+        assert(offset + size <= count);
+        return {ptr + offset, size};
+    }
+
+private:
+    T* ptr{nullptr};
+    std::size_t count{0};
+};
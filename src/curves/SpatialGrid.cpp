@@ -0,0 +1,161 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+SpatialGrid::SpatialGrid(double p_cellSize) : cellSize(p_cellSize) { assert(cellSize > 0); }
+
+void SpatialGrid::setCellSize(double p_cellSize, const std::vector<Point>& points)
+{
+    assert(p_cellSize > 0);
+    cellSize = p_cellSize;
+    build(points);
+}
+
+void SpatialGrid::build(const std::vector<Point>& points)
+{
+    clear();
+    pointCells.reserve(points.size());
+    for(std::size_t i{0}; i < points.size(); ++i)
+    {
+        insert(i, points[i]);
+    }
+}
+
+void SpatialGrid::insert(std::size_t idx, const Point& p)
+{
+    assert(idx == pointCells.size());
+    const auto cellKey = key(p);
+    cells[cellKey].push_back(idx);
+    pointCells.push_back(cellKey);
+}
+
+void SpatialGrid::move(std::size_t idx, [[maybe_unused]] const Point& p_old, const Point& p_new)
+{
+    assert(idx < pointCells.size() && pointCells[idx] == key(p_old));
+    const auto cellKey = key(p_new);
+    if(pointCells[idx] == cellKey)
+    {
+        return;
+    }
+    eraseFromCell(idx, pointCells[idx]);
+    cells[cellKey].push_back(idx);
+    pointCells[idx] = cellKey;
+}
+
+void SpatialGrid::erase(std::size_t idx, [[maybe_unused]] const Point& p)
+{
+    assert(idx < pointCells.size() && pointCells[idx] == key(p));
+    eraseFromCell(idx, pointCells[idx]);
+    // same as the vector of points, O(n - idx), the index of each following point is found in its own cell, which
+    // already holds the index below it once renumbered in increasing order
+    for(auto i = idx + 1; i < pointCells.size(); ++i)
+    {
+        auto& indices = cells[pointCells[i]];
+        *std::find(indices.begin(), indices.end(), i) = i - 1;
+    }
+    pointCells.erase(pointCells.begin() + static_cast<std::ptrdiff_t>(idx));
+}
+
+void SpatialGrid::clear()
+{
+    cells.clear();
+    pointCells.clear();
+}
+
+std::optional<std::size_t> SpatialGrid::closest(const std::vector<Point>& points,
+                                                const Point& p,
+                                                double threshold,
+                                                const CoordinateArrays* coordinates) const
+{
+    if(points.empty() || !(threshold >= 0))
+    {
+        return {};
+    }
+    const auto iMin = cellCoordinate(p.x - threshold);
+    const auto iMax = cellCoordinate(p.x + threshold);
+    const auto jMin = cellCoordinate(p.y - threshold);
+    const auto jMax = cellCoordinate(p.y + threshold);
+    // when the radius spans more cells than points, scanning the points is cheaper
+    const auto nbCells = static_cast<double>(iMax - iMin + 1) * static_cast<double>(jMax - jMin + 1);
+    if(nbCells > static_cast<double>(points.size()))
+    {
+        if(coordinates != nullptr)
+        {
+            assert(coordinates->size() == points.size());
+            return coordinates->closest(p, threshold);
+        }
+        return getClosestPointIndex(points, p, threshold);
+    }
+
+    auto closestDistance = std::numeric_limits<double>::max();
+    std::optional<std::size_t> res{};
+    for(auto i = iMin; i <= iMax; ++i)
+    {
+        for(auto j = jMin; j <= jMax; ++j)
+        {
+            const auto cell = cells.find(key(i, j));
+            if(cell == cells.end())
+            {
+                continue;
+            }
+            for(const auto idx : cell->second)
+            {
+                const auto dist = glm::distance(points[idx], p);
+                // the cells are not visited in the order of the indices, ties go to the lowest one as in a scan
+                const auto closer =
+                    dist < closestDistance || (!(closestDistance < dist) && res.has_value() && idx < res.value());
+                if(dist <= threshold && closer)
+                {
+                    closestDistance = dist;
+                    res = idx;
+                }
+            }
+        }
+    }
+    return res;
+}
+
+std::int64_t SpatialGrid::cellCoordinate(double value) const
+{
+    // the coordinates are clamped so that the keys of far away cells do not overflow
+    constexpr auto lowest = static_cast<double>(std::numeric_limits<std::int32_t>::min());
+    constexpr auto highest = static_cast<double>(std::numeric_limits<std::int32_t>::max());
+    const auto coordinate = std::floor(value / cellSize);
+    if(std::isnan(coordinate))
+    {
+        return 0;
+    }
+    return static_cast<std::int64_t>(std::clamp(coordinate, lowest, highest));
+}
+
+std::uint64_t SpatialGrid::key(const Point& p) const { return key(cellCoordinate(p.x), cellCoordinate(p.y)); }
+
+std::uint64_t SpatialGrid::key(std::int64_t i, std::int64_t j)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(i)) << 32U) |
+           static_cast<std::uint64_t>(static_cast<std::uint32_t>(j));
+}
+
+void SpatialGrid::eraseFromCell(std::size_t idx, std::uint64_t cellKey)
+{
+    const auto cell = cells.find(cellKey);
+    assert(cell != cells.end());
+    if(cell == cells.end())
+    {
+        return;
+    }
+    auto& indices = cell->second;
+    const auto it = std::find(indices.begin(), indices.end(), idx);
+    if(it != indices.end())
+    {
+        *it = indices.back();
+        indices.pop_back();
+    }
+    if(indices.empty())
+    {
+        cells.erase(cell);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoordinateArrays.h"
+#include "Point.h"
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A uniform grid over the plane storing the indices of a set of points in the cells containing them, so that the
+ * closest point within a radius is found by visiting only the cells overlapping the radius.
+ * Only the non-empty cells are stored, hence the grid is unbounded.
+ */
+class SpatialGrid
+{
+public:
+    /// the default size of the cells, in the unit of the points, e.g. in pixels
+    static constexpr double defaultCellSize{32.};
+
+    explicit SpatialGrid(double p_cellSize = defaultCellSize);
+
+    /**
+     * Sets the size of the cells and indexes the points again.
+     * @param p_cellSize The size of the cells, it must be positive
+     * @param points The points indexed by the grid
+     */
+    void setCellSize(double p_cellSize, const std::vector<Point>& points);
+
+    [[nodiscard]] double getCellSize() const { return cellSize; }
+
+    /**
+     * Indexes the given points, replacing the previous ones.
+     * @param points The points
+     */
+    void build(const std::vector<Point>& points);
+
+    /**
+     * Adds a point to the grid, after the points already indexed.
+     * @param idx The index of the point, the number of points already indexed
+     * @param p The point
+     */
+    void insert(std::size_t idx, const Point& p);
+
+    /**
+     * Moves a point of the grid.
+     * @param idx The index of the point
+     * @param p_old The previous position of the point
+     * @param p_new The new position of the point
+     */
+    void move(std::size_t idx, const Point& p_old, const Point& p_new);
+
+    /**
+     * Removes a point from the grid, the indices of the following points are shifted by one as in the vector of
+     * points, only visiting the cells of these points.
+     * @param idx The index of the point
+     * @param p The point
+     */
+    void erase(std::size_t idx, const Point& p);
+
+    /// removes all the points
+    void clear();
+
+    /**
+     * Finds the closest point within the threshold, with the same result as getClosestPointIndex().
+     * @param points The points indexed by the grid
+     * @param p The query point
+     * @param threshold The maximum distance from the query point
+     * @param coordinates The coordinates of the points as arrays if they are kept, scanned instead of the points when
+     * the radius spans more cells than there are points
+     * @return The index of the closest point, the lowest one in case of ties, if any
+     */
+    [[nodiscard]] std::optional<std::size_t> closest(const std::vector<Point>& points,
+                                                     const Point& p,
+                                                     double threshold,
+                                                     const CoordinateArrays* coordinates = nullptr) const;
+
+private:
+    [[nodiscard]] std::int64_t cellCoordinate(double value) const;
+
+    [[nodiscard]] std::uint64_t key(const Point& p) const;
+
+    static std::uint64_t key(std::int64_t i, std::int64_t j);
+
+    void eraseFromCell(std::size_t idx, std::uint64_t cellKey);
+
+    /// the size of the cells
+    double cellSize;
+    /// the indices of the points contained in each non-empty cell
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> cells;
+    /// the key of the cell of each point, by index
+    std::vector<std::uint64_t> pointCells;
+};
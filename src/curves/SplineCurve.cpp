@@ -0,0 +1,140 @@
+#include "SplineCurve.h"
+
+#include "parametrization.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+#include <functional>
+#include <numeric>
+
+namespace {
+/// the number of samples evaluated by a task when the evaluation is split across the threads
+constexpr std::size_t samplesPerTask{4096};
+}
+
+void SplineCurve::makeFromVector(const std::vector<Point>& points) { setControlPoints(points); }
+
+void SplineCurve::setControlPoints(const std::vector<Point>& points)
+{
+    ControlPoints::setControlPoints(points);
+    dirty = true;
+    publish({});
+}
+
+void SplineCurve::add(Point p)
+{
+    ControlPoints::add(p);
+    dirty = true;
+    publish({CurveChange::Edit::Append, {size() - 1, size()}, IndexRange::all()});
+}
+
+bool SplineCurve::deleteControlPoint(const Point& p, double threshold)
+{
+    const auto idx = getIndexClosestPoint(p, threshold);
+    if(idx.has_value())
+    {
+        deleteControlPointAtIndex(idx.value());
+        return true;
+    }
+    return false;
+}
+
+void SplineCurve::deleteControlPointAtIndex(std::size_t idx)
+{
+    ControlPoints::deleteControlPointAtIndex(idx);
+    dirty = true;
+    publish({CurveChange::Edit::Remove, {idx, idx + 1}, IndexRange::all()});
+}
+
+bool SplineCurve::updateControlPoint(const Point& p_old, const Point& p_new, double threshold)
+{
+    const auto idx = getIndexClosestPoint(p_old, threshold);
+    if(idx.has_value())
+    {
+        updateControlPointAtIndex(idx.value(), p_new, threshold);
+        return true;
+    }
+    return false;
+}
+
+void SplineCurve::updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold)
+{
+    ControlPoints::updateControlPointAtIndex(idx, p_new, threshold);
+    dirty = true;
+    publish({CurveChange::Edit::Move, {idx, idx + 1}, IndexRange::all()});
+}
+
+void SplineCurve::reset()
+{
+    ControlPoints::reset();
+    dirty = true;
+    publish({});
+}
+
+void SplineCurve::setParameters(const Parameters& p)
+{
+    param = p;
+    // the previous samples cannot be kept with another step
+    samples.clear();
+    dirty = true;
+    publish({CurveChange::Edit::Any, {}, IndexRange::all()});
+}
+
+const std::vector<Point>& SplineCurve::getCurve() const
+{
+    refresh();
+    return curve;
+}
+
+const CubicSpline<Point>& SplineCurve::getSpline() const
+{
+    refresh();
+    return spline;
+}
+
+void SplineCurve::refresh() const
+{
+    if(!dirty)
+    {
+        return;
+    }
+    CURVES_TRACE_SCOPE("SplineCurve::refresh");
+    const auto& points = getControlPoints();
+    nodes.resize(points.size());
+    switch(param.parametrization)
+    {
+        case Parametrization::Uniform:
+            std::iota(nodes.begin(), nodes.end(), 0.);
+            break;
+        case Parametrization::Distance:
+            computeDistanceSubdivision(points, nodes);
+            break;
+        case Parametrization::RootDistance:
+            computeRootDistanceSubdivision(points, nodes);
+            break;
+    }
+    // the duplicated consecutive points have the same node with a parametrization by distance, the spline passes
+    // through them once
+    const auto through = mergeRepeatedNodes<Point>(nodes, points, distinctPoints);
+    spline.build(nodes, through, param.boundary, param.startTangent, param.endTangent);
+    if(spline.size() < 2)
+    {
+        curve.clear();
+        dirty = false;
+        return;
+    }
+    // the nodes always start at 0, so the samples below the previous last node are unchanged
+    createSamples(param.step, nodes, samples, true);
+    curve.resize(samples.size());
+    // each range walks its own cursor along the increasing samples
+    const auto evaluate = [this](std::size_t begin, std::size_t end) {
+        CubicSpline<Point>::Cursor cursor(spline, samples[begin]);
+        for(auto i = begin; i < end; ++i)
+        {
+            curve[i] = cursor(samples[i]);
+        }
+    };
+    parallelFor(samples.size(), samplesPerTask, std::cref(evaluate));
+    // only once computed, so that the computation is tried again after an error
+    dirty = false;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "ControlPoints.h"
+#include "CubicSpline.h"
+#include "Point.h"
+
+#include <optional>
+#include <vector>
+
+/**
+ * A parametric cubic spline interpolating the control points. Unlike the Lagrange interpolations of
+ * InterpolationCurve, building it costs O(n) and evaluating a sample O(1), so it scales to millions of points.
+ */
+class SplineCurve : public ControlPoints
+{
+public:
+    /// the ways of computing the nodes of the points
+    enum class Parametrization
+    {
+        /// the index of the point
+        Uniform,
+        /// the length of the control polygon up to the point
+        Distance,
+        /// the sum of the square roots of the lengths of the segments of the control polygon up to the point
+        RootDistance
+    };
+
+    struct Parameters
+    {
+        Parameters() = default;
+        Parameters(double p_step,
+                   Parametrization p_parametrization,
+                   SplineBoundary p_boundary = SplineBoundary::Natural)
+            : step(p_step), parametrization(p_parametrization), boundary(p_boundary)
+        { }
+        /// the step between two parameter values, in the unit of the parametrization
+        double step{.1};
+        Parametrization parametrization{Parametrization::Distance};
+        SplineBoundary boundary{SplineBoundary::Natural};
+        /// the derivatives of the curve with respect to the parameter at its ends, for a clamped spline
+        Point startTangent{0, 0};
+        Point endTangent{0, 0};
+    };
+
+    explicit SplineCurve() = default;
+    explicit SplineCurve(const Parameters& p) : param(p) { }
+    ~SplineCurve() override = default;
+
+    /**
+     * Replaces the control points.
+     * @param points The new control points
+     */
+    void makeFromVector(const std::vector<Point>& points);
+
+    void add(Point p) override;
+
+    bool deleteControlPoint(const Point& p, double threshold) override;
+    void deleteControlPointAtIndex(std::size_t idx) override;
+
+    bool updateControlPoint(const Point& p_old, const Point& p_new, double threshold) override;
+    void updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold) override;
+
+    void reset() override;
+
+    void setControlPoints(const std::vector<Point>& points) override;
+
+    /**
+     * Sets the parameters of the spline, the curve is computed again when it is next requested.
+     * @param p The new parameters
+     */
+    void setParameters(const Parameters& p);
+
+    [[nodiscard]] const Parameters& getParameters() const { return param; }
+
+    /**
+     * The curve is computed on demand, the first time it is requested after a modification of the control points.
+     * @return the points of the curve, empty if there are less than two control points
+     * @throw std::invalid_argument if the spline cannot be built, e.g. from NaN coordinates, the curve being computed
+     * again on the next request
+     */
+    [[nodiscard]] const std::vector<Point>& getCurve() const;
+
+    /**
+     * @return the spline through the control points, its nodes being given by the parametrization
+     * @throw std::invalid_argument if the spline cannot be built, see getCurve()
+     */
+    [[nodiscard]] const CubicSpline<Point>& getSpline() const;
+
+private:
+    /// computes the spline and the curve again if they are outdated
+    void refresh() const;
+
+    Parameters param{};
+    /// whether the spline and the curve are outdated
+    mutable bool dirty{false};
+    mutable CubicSpline<Point> spline{};
+    /// the nodes of the control points, a node being kept once if it is repeated
+    mutable std::vector<double> nodes{};
+    /// the control points without the duplicated consecutive ones, only filled if there are some
+    mutable std::vector<Point> distinctPoints{};
+    /// the parameter values of the curve points
+    mutable std::vector<double> samples{};
+    mutable std::vector<Point> curve{};
+};
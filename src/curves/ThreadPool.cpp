@@ -0,0 +1,224 @@
+#include "ThreadPool.h"
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+
+#ifndef CURVES_THREAD_POOL_SIZE
+#define CURVES_THREAD_POOL_SIZE 0
+#endif
+
+struct ThreadPool::Job
+{
+    std::size_t count{0};
+    std::size_t grain{1};
+    std::size_t nbRanges{0};
+    const std::function<void(std::size_t, std::size_t)>* fn{nullptr};
+    std::atomic<std::size_t> next{0};
+    /// the number of helpers running ranges of the job, guarded by the mutex of the pool
+    std::size_t helpers{0};
+    /// signaled when the last helper leaves the job, with the mutex of the pool
+    std::condition_variable finished{};
+    /// the next running job of the pool
+    Job* nextJob{nullptr};
+    std::mutex errorMutex{};
+    std::exception_ptr error{};
+    /// the allocations made by the helpers, counted for the calling thread when the library is traced
+    std::atomic<std::size_t> allocations{0};
+
+    /// @return whether some ranges have not been taken yet
+    [[nodiscard]] bool hasRanges() const { return next.load(std::memory_order_relaxed) < nbRanges; }
+
+    /**
+     * Processes the ranges that have not been taken yet.
+     * @param helper Whether the thread is a helper of the calling thread
+     */
+    void run(bool helper)
+    {
+        for(auto range = next++; range < nbRanges; range = next++)
+        {
+            const auto traced = Tracer::isAvailable() && helper;
+            const auto before = traced ? Tracer::allocationCount() : 0;
+            try
+            {
+                const auto begin = range * grain;
+                (*fn)(begin, std::min(begin + grain, count));
+            }
+            catch(...)
+            {
+                const std::lock_guard<std::mutex> lock(errorMutex);
+                if(!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            if(traced)
+            {
+                allocations += Tracer::allocationCount() - before;
+            }
+        }
+    }
+};
+
+ThreadPool::ThreadPool(std::size_t nbThreads)
+{
+    threads.reserve(nbThreads);
+    for(std::size_t i = 0; i < nbThreads; ++i)
+    {
+        threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+}
+
+ThreadPool::Job* ThreadPool::findJob() const
+{
+    for(auto* job = jobs; job != nullptr; job = job->nextJob)
+    {
+        if(job->hasRanges())
+        {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        Job* job{nullptr};
+        available.wait(lock, [this, &job] {
+            job = findJob();
+            return stopping || job != nullptr || !tasks.empty();
+        });
+        if(job != nullptr)
+        {
+            // the calling thread does not leave the job while it has helpers
+            ++job->helpers;
+            lock.unlock();
+            job->run(true);
+            lock.lock();
+            if(--job->helpers == 0)
+            {
+                job->finished.notify_one();
+            }
+            continue;
+        }
+        if(tasks.empty())
+        {
+            return;
+        }
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count,
+                             std::size_t grain,
+                             const std::function<void(std::size_t, std::size_t)>& fn)
+{
+    if(count == 0)
+    {
+        return;
+    }
+    // the job stays on the stack: the helpers find it in the list of the pool, and the calling thread waits for them
+    // to leave it before returning, so that parallelFor does not allocate
+    Job job{};
+    job.count = count;
+    job.grain = std::max<std::size_t>(grain, 1);
+    job.nbRanges = (count + job.grain - 1) / job.grain;
+    job.fn = &fn;
+    const auto nbHelpers = std::min(size(), job.nbRanges - 1);
+    if(nbHelpers > 0)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            job.nextJob = jobs;
+            jobs = &job;
+        }
+        for(std::size_t i = 0; i < nbHelpers; ++i)
+        {
+            available.notify_one();
+        }
+    }
+    job.run(false);
+    if(nbHelpers > 0)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // no helper can join the job once it is unlinked, the ranges still running belong to the current helpers
+        auto** link = &jobs;
+        while(*link != &job)
+        {
+            link = &(*link)->nextJob;
+        }
+        *link = job.nextJob;
+        job.finished.wait(lock, [&job] { return job.helpers == 0; });
+    }
+    Tracer::addAllocations(job.allocations);
+    if(job.error)
+    {
+        std::rethrow_exception(job.error);
+    }
+}
+
+ThreadPool* ThreadPool::instance()
+{
+    static const auto pool = []() -> std::unique_ptr<ThreadPool> {
+        // the environment variable overrides the size chosen at build time, e.g. to test with or without the pool
+        long requested = CURVES_THREAD_POOL_SIZE;
+        if(const char* size = std::getenv("CURVES_THREAD_POOL_SIZE"); size != nullptr && *size != '\0')
+        {
+            requested = std::strtol(size, nullptr, 10);
+        }
+        // a negative size means one thread for each core, the calling thread taking part in the work as well
+        const auto nbThreads = requested >= 0
+                                   ? static_cast<std::size_t>(requested)
+                                   : std::max<std::size_t>(std::thread::hardware_concurrency(), 1) - 1;
+        if(nbThreads == 0)
+        {
+            return nullptr;
+        }
+        return std::make_unique<ThreadPool>(nbThreads);
+    }();
+    return pool.get();
+}
+
+void parallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn)
+{
+    auto* pool = ThreadPool::instance();
+    if(pool == nullptr || count <= grain)
+    {
+        fn(0, count);
+        return;
+    }
+    pool->parallelFor(count, grain, fn);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads executing the tasks submitted to a shared queue.
+ * The library uses a single instance, sized at build time with the CMake option CURVES_THREAD_POOL_SIZE, to build the
+ * curves concurrently and to split the evaluation of large sets of samples across the cores.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Creates the pool and starts its threads.
+     * @param nbThreads The number of worker threads
+     */
+    explicit ThreadPool(std::size_t nbThreads);
+
+    /**
+     * Waits for the queued tasks to be executed and joins the threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queues a task to be executed by one of the threads.
+     * @param task The task
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Calls fn on consecutive ranges [begin, end) covering [0, count), each one of at most grain elements.
+     * The ranges are processed by the calling thread together with the threads of the pool, so it can be called from
+     * a task of the pool itself. It returns once all the ranges have been processed, and rethrows the first exception
+     * thrown by fn, if any.
+     * @param count The number of elements
+     * @param grain The maximum number of elements of a range
+     * @param fn The function to call on each range
+     */
+    void parallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn);
+
+    [[nodiscard]] std::size_t size() const { return threads.size(); }
+
+    /**
+     * @return the pool shared by the library, or nullptr if the library is built without a pool. The size chosen at
+     * build time can be overridden by the environment variable CURVES_THREAD_POOL_SIZE, read when the pool is first
+     * used.
+     */
+    static ThreadPool* instance();
+
+private:
+    /// the state of a parallelFor, on the stack of the calling thread
+    struct Job;
+
+    void work();
+
+    /// @return the first running job with ranges left to take, nullptr if none, the mutex must be held
+    [[nodiscard]] Job* findJob() const;
+
+    std::vector<std::thread> threads{};
+    std::deque<std::function<void()>> tasks{};
+    /// the running parallelFor calls, linked through Job::nextJob so that publishing one does not allocate
+    Job* jobs{nullptr};
+    std::mutex mutex{};
+    std::condition_variable available{};
+    bool stopping{false};
+};
+
+/**
+ * Calls fn on consecutive ranges [begin, end) covering [0, count) using the pool of the library, or sequentially on
+ * the calling thread if there is no pool or if there is a single range.
+ * @param count The number of elements
+ * @param grain The maximum number of elements of a range
+ * @param fn The function to call on each range
+ */
+void parallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn);
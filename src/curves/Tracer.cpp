@@ -0,0 +1,123 @@
+#include "Tracer.h"
+
+#include <fstream>
+#include <iomanip>
+
+namespace {
+/// the counter installed by the executable
+std::atomic<Tracer::AllocationCounter> allocationCounter{nullptr};
+/// the allocations made by other threads for the current thread
+thread_local std::size_t adoptedAllocations{0};
+
+/// @return a small identifier of the current thread, in the order of their first event
+std::uint32_t threadIndex()
+{
+    static std::atomic<std::uint32_t> nbThreads{0};
+    thread_local const std::uint32_t index{nbThreads++};
+    return index;
+}
+
+/// @return the number of microseconds between the two times
+double microseconds(Tracer::Clock::time_point from, Tracer::Clock::time_point to)
+{
+    return std::chrono::duration<double, std::micro>(to - from).count();
+}
+}
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::setAllocationCounter(AllocationCounter counter) { allocationCounter.store(counter); }
+
+std::size_t Tracer::allocationCount()
+{
+    const auto counter = allocationCounter.load(std::memory_order_relaxed);
+    return counter == nullptr ? 0 : counter() + adoptedAllocations;
+}
+
+void Tracer::addAllocations(std::size_t count) { adoptedAllocations += count; }
+
+void Tracer::setEnabled(bool enable)
+{
+    if(enable)
+    {
+        // avoids the allocations of the events to be counted in the traced scopes, in most cases
+        const std::lock_guard<std::mutex> lock(mutex);
+        events.reserve(events.size() + 4096);
+    }
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Tracer::record(const char* name, Clock::time_point begin, Clock::time_point end, std::size_t allocations)
+{
+    const auto thread = threadIndex();
+    const std::lock_guard<std::mutex> lock(mutex);
+    if(events.size() < maxEvents)
+    {
+        events.push_back({name, begin, end, allocations, thread});
+    }
+}
+
+void Tracer::clear()
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+}
+
+std::size_t Tracer::size() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return events.size();
+}
+
+void Tracer::write(std::ostream& os) const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    // the timestamps are in microseconds, with a nanosecond resolution
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for(std::size_t i{0}; i < events.size(); ++i)
+    {
+        const auto& event = events[i];
+        // complete events, the names are identifiers that do not need to be escaped
+        os << (i == 0 ? "" : ",") << "\n{\"name\":\"" << event.name << "\",\"cat\":\"curves\",\"ph\":\"X\""
+           << ",\"ts\":" << microseconds(origin, event.begin) << ",\"dur\":" << microseconds(event.begin, event.end)
+           << ",\"pid\":1,\"tid\":" << event.thread << ",\"args\":{\"allocations\":" << event.allocations << "}}";
+    }
+    os << "\n]}\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+bool Tracer::write(const std::string& filename) const
+{
+    std::ofstream file(filename);
+    if(!file)
+    {
+        return false;
+    }
+    write(file);
+    return static_cast<bool>(file);
+}
+
+TraceScope::TraceScope(const char* p_name)
+    : name(p_name),
+      active(Tracer::instance().isEnabled()),
+      allocations(active ? Tracer::allocationCount() : 0),
+      begin(active ? Tracer::Clock::now() : Tracer::Clock::time_point{})
+{
+}
+
+TraceScope::~TraceScope()
+{
+    if(active)
+    {
+        const auto end = Tracer::Clock::now();
+        Tracer::instance().record(name, begin, end, Tracer::allocationCount() - allocations);
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Records the duration and the number of allocations of the scopes instrumented with CURVES_TRACE_SCOPE, and writes
+ * them as a Chrome trace that can be opened with chrome://tracing or https://ui.perfetto.dev.
+ * The scopes are instrumented only when the library is built with CURVES_ENABLE_TRACING, otherwise the macro expands
+ * to nothing and the tracer never records anything. The recording is started and stopped at run time.
+ */
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// the maximum number of events kept in memory, the following ones are dropped
+    static constexpr std::size_t maxEvents{1U << 20U};
+
+    /// @return the tracer shared by the whole process
+    static Tracer& instance();
+
+    /// @return true if the scopes are instrumented, i.e. if the library was built with CURVES_ENABLE_TRACING
+    static constexpr bool isAvailable()
+    {
+#ifdef CURVES_ENABLE_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// a function returning the number of allocations made by the calling thread since its start
+    using AllocationCounter = std::size_t (*)();
+
+    /**
+     * Installs the function counting the allocations recorded with the scopes. The library does not replace the
+     * global allocation functions: an executable measuring the allocations counts them itself, e.g. by linking
+     * AllocationCounter.cpp, and installs its counter here.
+     * @param counter The counter, or nullptr to stop counting the allocations
+     */
+    static void setAllocationCounter(AllocationCounter counter);
+
+    /**
+     * @return the number of allocations made by the calling thread, including the ones made for it by the threads of
+     * the pool during its parallelFor() calls, 0 if no counter is installed
+     */
+    static std::size_t allocationCount();
+
+    /**
+     * Adds allocations made by another thread for the calling thread, e.g. by a thread of the pool running a part of
+     * its parallelFor().
+     * @param count The number of allocations
+     */
+    static void addAllocations(std::size_t count);
+
+    /**
+     * Starts or stops the recording of the events.
+     * @param enable true to start the recording
+     */
+    void setEnabled(bool enable);
+
+    [[nodiscard]] bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Records a scope.
+     * @param name The name of the scope, it must outlive the tracer, e.g. a string literal
+     * @param begin The time the scope was entered
+     * @param end The time the scope was exited
+     * @param allocations The number of allocations made in the scope
+     */
+    void record(const char* name, Clock::time_point begin, Clock::time_point end, std::size_t allocations);
+
+    /// removes all the recorded events
+    void clear();
+
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * Writes the recorded events in the Chrome trace event format.
+     * @param os The output stream
+     */
+    void write(std::ostream& os) const;
+
+    /**
+     * Writes the recorded events in the Chrome trace event format.
+     * @param filename The path of the JSON file
+     * @return true if the file was written
+     */
+    bool write(const std::string& filename) const;
+
+private:
+    Tracer() = default;
+
+    struct Event
+    {
+        const char* name;
+        Clock::time_point begin;
+        Clock::time_point end;
+        std::size_t allocations;
+        std::uint32_t thread;
+    };
+
+    /// whether the events are recorded
+    std::atomic<bool> enabled{false};
+    /// the origin of the timestamps
+    Clock::time_point origin{Clock::now()};
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+};
+
+/**
+ * Records the enclosing scope in the tracer when it is destroyed, if the tracer is enabled.
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* p_name);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    bool active;
+    std::size_t allocations;
+    Tracer::Clock::time_point begin;
+};
+
+#ifdef CURVES_ENABLE_TRACING
+#define CURVES_TRACE_CONCAT_IMPL(a, b) a##b
+#define CURVES_TRACE_CONCAT(a, b) CURVES_TRACE_CONCAT_IMPL(a, b)
+/// records the duration and the allocations of the enclosing scope under the given name
+#define CURVES_TRACE_SCOPE(name) const TraceScope CURVES_TRACE_CONCAT(traceScope, __LINE__){name}
+#else
+#define CURVES_TRACE_SCOPE(name)
+#endif
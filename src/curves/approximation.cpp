@@ -1,5 +1,88 @@
 #include "approximation.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace {
+
+/**
+ * Evaluates the curve at each parameter value, the intermediate points being stored in temp.
+ */
+void evaluateDeCasteljau(Span<const Point> controlPoints, Span<const double> t, Span<Point> out, Point* temp)
+{
+    const auto last = controlPoints.size() - 1;
+    for(std::size_t s = 0; s < t.size(); ++s)
+    {
+        std::copy(controlPoints.begin(), controlPoints.end(), temp);
+        // lerping n (n - 1) / 2 times
+        for(std::size_t i = last; i > 0; --i)
+        {
+            for(std::size_t j = 0; j < i; ++j)
+                temp[j] = lerp(temp[j], temp[j + 1], t[s]);
+        }
+        out[s] = temp[0];
+    }
+}
+
+/**
+ * @return true if all the control points are within the tolerance from the chord joining the first and the last one.
+ */
+bool isFlat(const Point* polygon, std::size_t size, double tolerance)
+{
+    const auto& first = polygon[0];
+    const auto chord = polygon[size - 1] - first;
+    const auto chordLength2 = glm::dot(chord, chord);
+    for(std::size_t i = 1; i + 1 < size; ++i)
+    {
+        // distance to the chord segment, so that points projecting out of it (e.g. in loops) are not taken as flat
+        const auto v = polygon[i] - first;
+        const auto u = chordLength2 > 0 ? std::clamp(glm::dot(v, chord) / chordLength2, 0., 1.) : 0.;
+        const auto d = v - u * chord;
+        if(glm::dot(d, d) > tolerance * tolerance)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Appends the vertices of the polygon stored at the given offset of the stack, without its first point.
+ * The two halves are stored right after the polygon, the right one first, so that the halves of the left one can
+ * overwrite the right one once it is processed.
+ */
+void subdivide(Point* stack,
+               std::size_t offset,
+               std::size_t size,
+               double tolerance,
+               unsigned depth,
+               std::vector<Point>& out)
+{
+    const auto* polygon = stack + offset;
+    if(depth == 0 || isFlat(polygon, size, tolerance))
+    {
+        out.push_back(polygon[size - 1]);
+        return;
+    }
+    auto* right = stack + offset + size;
+    auto* left = stack + offset + 2 * size;
+    // deCasteljau at t = 0.5, the left side of the triangle gives the left half, its right side the right half
+    std::copy(polygon, polygon + size, right);
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        left[i] = right[0];
+        for(std::size_t j = 0; j + 1 < size - i; ++j)
+        {
+            right[j] = lerp(right[j], right[j + 1], 0.5);
+        }
+    }
+    subdivide(stack, offset + 2 * size, size, tolerance, depth - 1, out);
+    subdivide(stack, offset + size, size, tolerance, depth - 1, out);
+}
+
+}
+
 Point deCasteljau(std::vector<Point> controlPoints, std::size_t start, std::size_t end, double t)
 {
     // lerping n (n - 1) / 2 times
@@ -9,4 +92,47 @@ Point deCasteljau(std::vector<Point> controlPoints, std::size_t start, std::size
             controlPoints[j] = lerp(controlPoints[j], controlPoints[j + 1], t);
     }
     return controlPoints[start];
-}
\ No newline at end of file
+}
+
+void deCasteljau(Span<const Point> controlPoints, Span<const double> t, Span<Point> out, std::vector<Point>& workspace)
+{
+    assert(!controlPoints.empty());
+    assert(t.size() == out.size());
+    if(controlPoints.size() <= deCasteljauStackSize)
+    {
+        std::array<Point, deCasteljauStackSize> temp;
+        evaluateDeCasteljau(controlPoints, t, out, temp.data());
+        return;
+    }
+    if(workspace.size() < controlPoints.size())
+    {
+        workspace.resize(controlPoints.size());
+    }
+    evaluateDeCasteljau(controlPoints, t, out, workspace.data());
+}
+
+void deCasteljau(Span<const Point> controlPoints, Span<const double> t, Span<Point> out)
+{
+    std::vector<Point> workspace{};
+    deCasteljau(controlPoints, t, out, workspace);
+}
+
+void adaptiveTessellation(Span<const Point> controlPoints,
+                          double tolerance,
+                          std::vector<Point>& out,
+                          std::vector<Point>& workspace,
+                          unsigned maxDepth)
+{
+    assert(!controlPoints.empty());
+    out.clear();
+    out.push_back(controlPoints.front());
+    const auto size = controlPoints.size();
+    if(size == 1)
+    {
+        return;
+    }
+    // each level of recursion stores two polygons after the current one
+    workspace.resize(size * (2 * static_cast<std::size_t>(maxDepth) + 1));
+    std::copy(controlPoints.begin(), controlPoints.end(), workspace.begin());
+    subdivide(workspace.data(), 0, size, tolerance, maxDepth, out);
+}
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "Point.h"
+#include "Span.h"
+
 #include <vector>
 
+/// the maximum number of control points for which deCasteljau() keeps the intermediate points on the stack
+constexpr std::size_t deCasteljauStackSize{32};
+
 /**
  *
  * @param start
@@ -10,4 +15,42 @@
  * @param t
  * @return
  */
-Point deCasteljau(std::vector<Point> controlPoints, std::size_t start, std::size_t end, double t);
\ No newline at end of file
+Point deCasteljau(std::vector<Point> controlPoints, std::size_t start, std::size_t end, double t);
+
+/**
+ * Evaluates the Bezier curve defined by the given control points at each of the given parameter values, using the
+ * deCasteljau's algorithm.
+ * The intermediate points are stored on the stack for curves with at most deCasteljauStackSize control points, in the
+ * given workspace otherwise, so no memory is allocated once the workspace is large enough.
+ * @param controlPoints The control points of the curve, it must not be empty
+ * @param t The parameter values
+ * @param out The evaluated points, it must have the same size as t
+ * @param workspace The working memory used for the curves with many control points
+ */
+void deCasteljau(Span<const Point> controlPoints, Span<const double> t, Span<Point> out, std::vector<Point>& workspace);
+
+/**
+ * Evaluates the Bezier curve defined by the given control points at each of the given parameter values, using the
+ * deCasteljau's algorithm. It allocates its working memory at most once for all the parameter values.
+ * @param controlPoints The control points of the curve, it must not be empty
+ * @param t The parameter values
+ * @param out The evaluated points, it must have the same size as t
+ */
+void deCasteljau(Span<const Point> controlPoints, Span<const double> t, Span<Point> out);
+
+/**
+ * Tessellates the Bezier curve defined by the given control points by recursively splitting its control polygon in
+ * two halves until each part is flat, i.e. until all its control points are within the tolerance from its chord.
+ * Since the curve lies in the convex hull of its control polygon, the polyline made of the chords stays within the
+ * tolerance from the curve, so flat stretches get few vertices and tight bends get many.
+ * @param controlPoints The control points of the curve, it must not be empty
+ * @param tolerance The maximum distance between the curve and the polyline, e.g. in pixels
+ * @param out The vertices of the polyline, from the first to the last control point
+ * @param workspace The working memory storing the split control polygons
+ * @param maxDepth The maximum number of recursive splits, bounding the number of vertices to 2^maxDepth + 1
+ */
+void adaptiveTessellation(Span<const Point> controlPoints,
+                          double tolerance,
+                          std::vector<Point>& out,
+                          std::vector<Point>& workspace,
+                          unsigned maxDepth = 16);
@@ -1,5 +1,257 @@
 #include "interpolation.h"
 
+#include "simd.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+/**
+ * @brief Computes the factor applied to the differences of the nodes to avoid overflows or underflows of their
+ * products when the number of nodes grows, i.e. the inverse of a quarter of the interval length.
+ * @param[in] T The list of nodes.
+ * @return the scale factor.
+ */
+double nodesScale(const std::vector<double>& T)
+{
+    const auto [minIt, maxIt] = std::minmax_element(T.begin(), T.end());
+    return 4.0 / (*maxIt - *minIt);
+}
+
+/// the number of samples evaluated by a task when the evaluation is split across the threads
+constexpr std::size_t samplesPerTask{2048};
+
+/**
+ * @brief Evaluates a curve by blocks of parameter values, each block filling all the lanes of a simd::Pack.
+ * The last block is padded by repeating the last parameter value. Large sets of parameter values are split in ranges
+ * evaluated concurrently, each sample being written at its own position so the result does not depend on the order
+ * of evaluation.
+ * @param[in] tToEval The list of parameter values to evaluate.
+ * @param[out] curve The list of points of the curve, its memory is reused.
+ * @param[in] makeKernel The function creating the kernel used to evaluate the blocks of a range, called with the index
+ * of the range so that a kernel can use its own part of a working memory. The kernel takes the packed parameters, the number of valid lanes, the pointer to the
+ * first parameter value and the pointer to the first output point.
+ */
+template <typename MakeKernel>
+void evaluateByBlocks(const std::vector<double>& tToEval, std::vector<Point>& curve, const MakeKernel& makeKernel)
+{
+    constexpr auto lanes = simd::Pack::size;
+    static_assert(samplesPerTask % lanes == 0, "the ranges must contain whole blocks");
+    curve.resize(tToEval.size());
+    const auto evaluate = [&](std::size_t begin, std::size_t end) {
+        auto kernel = makeKernel(begin / samplesPerTask);
+        std::array<double, lanes> block{};
+        for(std::size_t first = begin; first < end; first += lanes)
+        {
+            const auto count = std::min(lanes, end - first);
+            for(std::size_t l = 0; l < lanes; ++l)
+            {
+                block[l] = tToEval[first + std::min(l, count - 1)];
+            }
+            kernel(simd::Pack::load(block.data()), count, &tToEval[first], &curve[first]);
+        }
+    };
+    // a std::function holding a reference does not allocate, whatever the size of the captures
+    parallelFor(tToEval.size(), samplesPerTask, std::cref(evaluate));
+}
+
+/**
+ * @brief Computes a point of the parametric curve with the barycentric formula, both coordinates at once.
+ */
+Point barycentricPoint(double t,
+                       Span<const double> X,
+                       Span<const double> Y,
+                       const std::vector<double>& T,
+                       const std::vector<double>& W)
+{
+    Point num{0, 0};
+    double den{0};
+    for(std::size_t i = 0; i < T.size(); ++i)
+    {
+        const auto diff = t - T[i];
+        if(std::fpclassify(diff) == FP_ZERO)
+        {
+            return {X[i], Y[i]};
+        }
+        const auto q = W[i] / diff;
+        num += q * Point{X[i], Y[i]};
+        den += q;
+    }
+    return num / den;
+}
+
+/**
+ * @brief The k nodes closest to a parameter value, with their barycentric weights. The nodes are sorted, so the
+ * closest ones form a range that slides along them as the parameter moves, each step updating the weights in O(k).
+ */
+class LagrangeWindow
+{
+public:
+    /**
+     * @param[in] p_X The list of x coordinates of the points.
+     * @param[in] p_Y The list of y coordinates of the points.
+     * @param[in] p_T The list of nodes, sorted in increasing or decreasing order.
+     * @param[in] k The number of nodes of the window, all the nodes if 0.
+     */
+    LagrangeWindow(Span<const double> p_X, Span<const double> p_Y, Span<const double> p_T, std::size_t k)
+        : X(p_X),
+          Y(p_Y),
+          T(p_T),
+          size(k == 0 ? T.size() : std::min(k, T.size())),
+          descending(T.size() > 1 && T.front() > T.back()),
+          weights(size)
+    {
+    }
+
+    /**
+     * @brief Computes the point of the curve, the previous window being slid to the given parameter value.
+     * @param[in] t The parameter value.
+     * @return the point of the Lagrange curve of the nodes of the window.
+     */
+    Point operator()(double t)
+    {
+        if(!placed)
+        {
+            place(t);
+        }
+        while(first + size < T.size() && t - node(first) > node(first + size) - t)
+        {
+            slideUp();
+        }
+        while(first > 0 && node(first + size - 1) - t > t - node(first - 1))
+        {
+            slideDown();
+        }
+        Point num{0, 0};
+        double den{0};
+        for(auto j = first; j < first + size; ++j)
+        {
+            const auto diff = t - node(j);
+            if(std::fpclassify(diff) == FP_ZERO)
+            {
+                return {X[index(j)], Y[index(j)]};
+            }
+            const auto q = weight(j) / diff;
+            num += q * Point{X[index(j)], Y[index(j)]};
+            den += q;
+        }
+        return num / den;
+    }
+
+private:
+    /// @return the index in T of the j-th node in increasing order
+    [[nodiscard]] std::size_t index(std::size_t j) const { return descending ? T.size() - 1 - j : j; }
+
+    [[nodiscard]] double node(std::size_t j) const { return T[index(j)]; }
+
+    /// the weights are stored in a ring buffer, the slot of the node leaving the window is taken by the entering one
+    double& weight(std::size_t j) { return weights[j % size]; }
+
+    /**
+     * @brief Finds the window of the first parameter value by a binary search, and computes its weights.
+     */
+    void place(double t)
+    {
+        std::size_t lo{0};
+        std::size_t hi{T.size()};
+        while(lo < hi)
+        {
+            const auto mid = lo + (hi - lo) / 2;
+            (node(mid) < t ? lo = mid + 1 : hi = mid);
+        }
+        first = std::min(lo - std::min(lo, size / 2), T.size() - size);
+        placed = true;
+        computeWeights();
+    }
+
+    /**
+     * @brief Computes the weights of the window from scratch in O(k^2), scaled as in barycentricWeights().
+     */
+    void computeWeights()
+    {
+        const auto last = first + size - 1;
+        scale = last > first ? 4.0 / (node(last) - node(first)) : 1.;
+        for(auto j = first; j <= last; ++j)
+        {
+            double prod{1};
+            for(auto i = first; i <= last; ++i)
+            {
+                if(i != j)
+                {
+                    prod *= (node(j) - node(i)) * scale;
+                }
+            }
+            weight(j) = 1.0 / prod;
+        }
+        slides = 0;
+    }
+
+    /**
+     * @brief Replaces a node of the window by another one, the weights of the other nodes being updated in O(k).
+     * @param[in] leaving The index of the node leaving the window.
+     * @param[in] entering The index of the node entering the window.
+     * @param[in] begin The first index of the nodes staying in the window.
+     */
+    void replace(std::size_t leaving, std::size_t entering, std::size_t begin)
+    {
+        const auto removed = node(leaving);
+        const auto added = node(entering);
+        double prod{1};
+        for(auto j = begin; j < begin + size - 1; ++j)
+        {
+            weight(j) *= (node(j) - removed) / (node(j) - added);
+            prod *= (added - node(j)) * scale;
+        }
+        weight(entering) = 1.0 / prod;
+    }
+
+    void slideUp()
+    {
+        replace(first, first + size, first + 1);
+        ++first;
+        afterSlide();
+    }
+
+    void slideDown()
+    {
+        replace(first + size - 1, first - 1, first);
+        --first;
+        afterSlide();
+    }
+
+    /// the rounding errors of the updates are bounded by computing the weights again after k slides, which keeps the
+    /// amortized cost of a slide in O(k)
+    void afterSlide()
+    {
+        if(++slides >= size)
+        {
+            computeWeights();
+        }
+    }
+
+    Span<const double> X;
+    Span<const double> Y;
+    Span<const double> T;
+    /// the number of nodes of the window
+    std::size_t size;
+    bool descending;
+    /// the weights of the nodes of the window
+    std::vector<double> weights;
+    /// the rank of the first node of the window in increasing order
+    std::size_t first{0};
+    bool placed{false};
+    /// the factor applied to the differences of the nodes in the weights
+    double scale{1};
+    std::size_t slides{0};
+};
+
+}
+
 
 double lagrange(double x, const std::vector<double>& X, const std::vector<double>& Y)
 {
@@ -25,21 +277,40 @@ double lagrange(double x, const std::vector<double>& X, const std::vector<double
 std::pair<std::vector<double>, std::vector<double>> splitCoordinates(const std::vector<Point>& points)
 {
     std::vector<double> X{};
-    X.reserve(points.size());
     std::vector<double> Y{};
-    Y.reserve(points.size());
-    for(const auto& p : points)
+    splitCoordinates(points, X, Y);
+    return {X, Y};
+}
+
+void splitCoordinates(Span<const Point> points, std::vector<double>& X, std::vector<double>& Y)
+{
+    X.resize(points.size());
+    Y.resize(points.size());
+    for(std::size_t i = 0; i < points.size(); ++i)
     {
-        X.push_back(p.x);
-        Y.push_back(p.y);
+        X[i] = points[i].x;
+        Y[i] = points[i].y;
     }
-    return {X, Y};
 }
 
 double lagrange(double x, const std::vector<Point>& points)
 {
-    const auto[X, Y] = splitCoordinates(points);
-    return lagrange(x, X, Y);
+    // same as lagrange(x, X, Y), reading the coordinates in place
+    const auto numPts = points.size();
+    double sum{0};
+    for(std::size_t i = 0; i < numPts; ++i)
+    {
+        double value{1};
+        for(std::size_t j = 0; j < numPts; ++j)
+        {
+            if(i != j)
+            {
+                value = value * (x - points[j].x) / (points[i].x - points[j].x);
+            }
+        }
+        sum = sum + points[i].y * value;
+    }
+    return sum;
 }
 
 std::vector<Point> applyLagrangeSubdivision(const std::vector<Point>& points,
@@ -55,14 +326,303 @@ std::vector<Point> applyLagrangeSubdivision(const std::vector<double>& X,
                                             const std::vector<double>& T,
                                             const std::vector<double>& tToEval)
 {
-    const auto numSamples{tToEval.size()};
     std::vector<Point> curve{};
-    curve.reserve(numSamples);
-    for (auto t : tToEval)
+    LagrangeWorkspace workspace{};
+    applyLagrangeSubdivision(X, Y, T, tToEval, curve, workspace);
+    return curve;
+}
+
+void applyLagrangeSubdivision(Span<const double> X,
+                              Span<const double> Y,
+                              const std::vector<double>& T,
+                              const std::vector<double>& tToEval,
+                              std::vector<Point>& curve,
+                              LagrangeWorkspace& workspace)
+{
+    CURVES_TRACE_SCOPE("applyLagrangeSubdivision");
+    assert(X.size() == T.size());
+    assert(Y.size() == T.size());
+    const auto numPts = T.size();
+    if(numPts < 2)
+    {
+        curve.assign(tToEval.size(), numPts == 0 ? Point{0, 0} : Point{X[0], Y[0]});
+        return;
+    }
+    if(workspace.nodes != T)
     {
-        const auto xpoint = lagrange(t, T, X);
-        const auto ypoint = lagrange(t, T, Y);
-        curve.emplace_back(xpoint, ypoint);
+        workspace.nodes = T;
+        barycentricWeights(T, workspace.weights);
     }
+    // each range of parameter values has its own running products
+    constexpr auto lanes = simd::Pack::size;
+    const auto nbRanges = (tToEval.size() + samplesPerTask - 1) / samplesPerTask;
+    workspace.left.resize(nbRanges * numPts * lanes);
+    // each basis polynomial is the weight of its node times the product of the other (t - T_j), which is obtained
+    // from the running products on the left and on the right of the node, so it is computed once for both the
+    // coordinates and without any division, even on the nodes
+    const auto& W = workspace.weights;
+    const auto scale = simd::Pack::broadcast(nodesScale(T));
+    evaluateByBlocks(tToEval, curve, [&](std::size_t range) {
+        return [&, left = workspace.left.data() + range * numPts * lanes](
+                   simd::Pack t, std::size_t count, const double*, Point* out) {
+            auto prod = simd::Pack::broadcast(1.0);
+            for(std::size_t i = 0; i < numPts; ++i)
+            {
+                prod.store(left + i * lanes);
+                prod = prod * ((t - simd::Pack::broadcast(T[i])) * scale);
+            }
+            auto xsum = simd::Pack::broadcast(0.0);
+            auto ysum = simd::Pack::broadcast(0.0);
+            auto right = simd::Pack::broadcast(1.0);
+            for(std::size_t i = numPts; i-- > 0;)
+            {
+                const auto basis = simd::Pack::broadcast(W[i]) * simd::Pack::load(left + i * lanes) * right;
+                xsum = xsum + basis * simd::Pack::broadcast(X[i]);
+                ysum = ysum + basis * simd::Pack::broadcast(Y[i]);
+                right = right * ((t - simd::Pack::broadcast(T[i])) * scale);
+            }
+            std::array<double, simd::Pack::size> xs{};
+            std::array<double, simd::Pack::size> ys{};
+            xsum.store(xs.data());
+            ysum.store(ys.data());
+            for(std::size_t l = 0; l < count; ++l)
+            {
+                out[l] = {xs[l], ys[l]};
+            }
+        };
+    });
+}
+
+std::vector<double> barycentricWeights(const std::vector<double>& T)
+{
+    std::vector<double> W{};
+    barycentricWeights(T, W);
+    return W;
+}
+
+void barycentricWeights(const std::vector<double>& T, std::vector<double>& W)
+{
+    const auto numPts = T.size();
+    W.assign(numPts, 1.0);
+    if(numPts < 2)
+    {
+        return;
+    }
+    // the common scale factor cancels out in the barycentric formula
+    const auto scale = nodesScale(T);
+    for(std::size_t i = 0; i < numPts; ++i)
+    {
+        double prod{1};
+        for(std::size_t j = 0; j < numPts; ++j)
+        {
+            if(i != j)
+            {
+                prod *= (T[i] - T[j]) * scale;
+            }
+        }
+        W[i] = 1.0 / prod;
+    }
+}
+
+double barycentric(double x, const std::vector<double>& T, const std::vector<double>& W, const std::vector<double>& Y)
+{
+    assert(T.size() == W.size());
+    assert(T.size() == Y.size());
+    double num{0};
+    double den{0};
+    for(std::size_t i = 0; i < T.size(); ++i)
+    {
+        const auto diff = x - T[i];
+        // the formula is singular on the nodes, where the polynomial takes the node value
+        if(std::fpclassify(diff) == FP_ZERO)
+        {
+            return Y[i];
+        }
+        const auto q = W[i] / diff;
+        num += q * Y[i];
+        den += q;
+    }
+    return num / den;
+}
+
+std::vector<Point> applyBarycentricSubdivision(const std::vector<double>& X,
+                                               const std::vector<double>& Y,
+                                               const std::vector<double>& T,
+                                               const std::vector<double>& W,
+                                               const std::vector<double>& tToEval)
+{
+    std::vector<Point> curve{};
+    applyBarycentricSubdivision(X, Y, T, W, tToEval, curve);
     return curve;
-}
\ No newline at end of file
+}
+
+void applyBarycentricSubdivision(Span<const double> X,
+                                 Span<const double> Y,
+                                 const std::vector<double>& T,
+                                 const std::vector<double>& W,
+                                 const std::vector<double>& tToEval,
+                                 std::vector<Point>& curve)
+{
+    CURVES_TRACE_SCOPE("applyBarycentricSubdivision");
+    assert(X.size() == T.size());
+    assert(Y.size() == T.size());
+    assert(W.size() == T.size());
+    evaluateByBlocks(tToEval, curve, [&](std::size_t) {
+        return [&](simd::Pack t, std::size_t count, const double* ts, Point* out) {
+            auto xsum = simd::Pack::broadcast(0.0);
+            auto ysum = simd::Pack::broadcast(0.0);
+            auto den = simd::Pack::broadcast(0.0);
+            int onNode{0};
+            for(std::size_t i = 0; i < T.size(); ++i)
+            {
+                const auto diff = t - simd::Pack::broadcast(T[i]);
+                onNode |= simd::zeroMask(diff);
+                const auto q = simd::Pack::broadcast(W[i]) / diff;
+                xsum = xsum + q * simd::Pack::broadcast(X[i]);
+                ysum = ysum + q * simd::Pack::broadcast(Y[i]);
+                den = den + q;
+            }
+            std::array<double, simd::Pack::size> xs{};
+            std::array<double, simd::Pack::size> ys{};
+            (xsum / den).store(xs.data());
+            (ysum / den).store(ys.data());
+            for(std::size_t l = 0; l < count; ++l)
+            {
+                // the lanes falling on a node are singular, they are computed again one by one
+                out[l] = (onNode & (1 << l)) != 0 ? barycentricPoint(ts[l], X, Y, T, W) : Point{xs[l], ys[l]};
+            }
+        };
+    });
+}
+
+std::vector<Point> applyWindowedLagrangeSubdivision(const std::vector<double>& X,
+                                                    const std::vector<double>& Y,
+                                                    const std::vector<double>& T,
+                                                    std::size_t window,
+                                                    const std::vector<double>& tToEval)
+{
+    std::vector<Point> curve{};
+    applyWindowedLagrangeSubdivision(X, Y, T, window, tToEval, curve);
+    return curve;
+}
+
+void applyWindowedLagrangeSubdivision(Span<const double> X,
+                                      Span<const double> Y,
+                                      Span<const double> T,
+                                      std::size_t window,
+                                      const std::vector<double>& tToEval,
+                                      std::vector<Point>& curve)
+{
+    CURVES_TRACE_SCOPE("applyWindowedLagrangeSubdivision");
+    assert(X.size() == T.size());
+    assert(Y.size() == T.size());
+    if(T.empty())
+    {
+        curve.assign(tToEval.size(), Point{0, 0});
+        return;
+    }
+    curve.resize(tToEval.size());
+    // each range slides its own window along its parameter values
+    const auto evaluate = [&](std::size_t begin, std::size_t end) {
+        LagrangeWindow lagrangeWindow(X, Y, T, window);
+        for(auto i = begin; i < end; ++i)
+        {
+            curve[i] = lagrangeWindow(tToEval[i]);
+        }
+    };
+    parallelFor(tToEval.size(), samplesPerTask, std::cref(evaluate));
+}
+
+std::vector<Point> applyNewtonSubdivision(const std::vector<double>& T,
+                                          const std::vector<Point>& coefficients,
+                                          const std::vector<double>& tToEval)
+{
+    std::vector<Point> curve{};
+    applyNewtonSubdivision(T, coefficients, tToEval, curve);
+    return curve;
+}
+
+void applyNewtonSubdivision(const std::vector<double>& T,
+                            const std::vector<Point>& coefficients,
+                            const std::vector<double>& tToEval,
+                            std::vector<Point>& curve)
+{
+    CURVES_TRACE_SCOPE("applyNewtonSubdivision");
+    assert(coefficients.size() == T.size());
+    if(T.empty())
+    {
+        curve.assign(tToEval.size(), Point{0, 0});
+        return;
+    }
+    const auto last = T.size() - 1;
+    evaluateByBlocks(tToEval, curve, [&](std::size_t) {
+        return [&](simd::Pack t, std::size_t count, const double*, Point* out) {
+            auto xs = simd::Pack::broadcast(coefficients[last].x);
+            auto ys = simd::Pack::broadcast(coefficients[last].y);
+            for(std::size_t k = last; k > 0; --k)
+            {
+                const auto diff = t - simd::Pack::broadcast(T[k - 1]);
+                xs = xs * diff + simd::Pack::broadcast(coefficients[k - 1].x);
+                ys = ys * diff + simd::Pack::broadcast(coefficients[k - 1].y);
+            }
+            std::array<double, simd::Pack::size> xres{};
+            std::array<double, simd::Pack::size> yres{};
+            xs.store(xres.data());
+            ys.store(yres.data());
+            for(std::size_t l = 0; l < count; ++l)
+            {
+                out[l] = {xres[l], yres[l]};
+            }
+        };
+    });
+}
+
+std::vector<Point> applyChebycheffSubdivision(const std::vector<Point>& coefficients,
+                                              const std::vector<double>& tToEval)
+{
+    std::vector<Point> curve{};
+    applyChebycheffSubdivision(coefficients, tToEval, curve);
+    return curve;
+}
+
+void applyChebycheffSubdivision(const std::vector<Point>& coefficients,
+                                const std::vector<double>& tToEval,
+                                std::vector<Point>& curve)
+{
+    CURVES_TRACE_SCOPE("applyChebycheffSubdivision");
+    if(coefficients.empty())
+    {
+        curve.assign(tToEval.size(), Point{0, 0});
+        return;
+    }
+    const auto last = coefficients.size() - 1;
+    evaluateByBlocks(tToEval, curve, [&](std::size_t) {
+        return [&](simd::Pack t, std::size_t count, const double*, Point* out) {
+            // the Clenshaw recurrence b_k = c_k + 2 t b_k+1 - b_k+2, the curve being c_0 + t b_1 - b_2
+            const auto twoT = t + t;
+            auto xs = simd::Pack::broadcast(0.);
+            auto ys = simd::Pack::broadcast(0.);
+            auto xsNext = simd::Pack::broadcast(0.);
+            auto ysNext = simd::Pack::broadcast(0.);
+            for(std::size_t k = last; k > 0; --k)
+            {
+                const auto x = simd::Pack::broadcast(coefficients[k].x) + twoT * xs - xsNext;
+                const auto y = simd::Pack::broadcast(coefficients[k].y) + twoT * ys - ysNext;
+                xsNext = xs;
+                ysNext = ys;
+                xs = x;
+                ys = y;
+            }
+            xs = simd::Pack::broadcast(coefficients[0].x) + t * xs - xsNext;
+            ys = simd::Pack::broadcast(coefficients[0].y) + t * ys - ysNext;
+            std::array<double, simd::Pack::size> xres{};
+            std::array<double, simd::Pack::size> yres{};
+            xs.store(xres.data());
+            ys.store(yres.data());
+            for(std::size_t l = 0; l < count; ++l)
+            {
+                out[l] = {xres[l], yres[l]};
+            }
+        };
+    });
+}
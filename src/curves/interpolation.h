@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Point.h"
+#include "Span.h"
+#include <utility>
 #include <vector>
 
 /**
@@ -20,11 +22,182 @@ double lagrange(double x, const std::vector<double>& X, const std::vector<double
  */
 double lagrange(double x, const std::vector<Point>& points);
 
+/**
+ * @brief Splits a list of points into the two lists of their x and y coordinates.
+ * @param[in] points The list of points.
+ * @return the pair of lists of x and y coordinates.
+ */
+std::pair<std::vector<double>, std::vector<double>> splitCoordinates(const std::vector<Point>& points);
+
+/**
+ * @brief Splits the points in the list of their x coordinates and the list of their y coordinates, reusing the
+ * memory of the lists.
+ * @param[in] points The list of points.
+ * @param[out] X The list of x coordinates.
+ * @param[out] Y The list of y coordinates.
+ */
+void splitCoordinates(Span<const Point> points, std::vector<double>& X, std::vector<double>& Y);
+
+/**
+ * @brief Computes the weights of the barycentric form of the Lagrange polynomial for the given nodes.
+ * The weights depend only on the nodes, hence they can be computed once and reused for any set of values.
+ * They are computed up to a common scale factor, which cancels out in the barycentric formula.
+ * @param[in] T The list of nodes, they must be distinct.
+ * @return the list of barycentric weights, one for each node.
+ */
+std::vector<double> barycentricWeights(const std::vector<double>& T);
+
+/**
+ * @brief Same as barycentricWeights(), the weights being written in a list whose memory is reused.
+ */
+void barycentricWeights(const std::vector<double>& T, std::vector<double>& W);
+
+/**
+ * @brief Computes the value in x of the Lagrange polynomial using its barycentric (second) form.
+ * It requires O(n) operations once the weights are known.
+ * @param[in] x The x coordinate of the point to compute.
+ * @param[in] T The list of nodes.
+ * @param[in] W The list of barycentric weights of the nodes, as computed by barycentricWeights().
+ * @param[in] Y The list of values at the nodes.
+ * @return the value in x of the Lagrange polynomial.
+ */
+double barycentric(double x, const std::vector<double>& T, const std::vector<double>& W, const std::vector<double>& Y);
+
+/**
+ * @brief Computes the points of the parametric Lagrange curve for each parameter value.
+ * Each basis polynomial is computed once and used for both the coordinates, and the parameter values are evaluated
+ * by blocks using the SIMD registers available on the target.
+ * @param[in] X The list of x coordinates of the points.
+ * @param[in] Y The list of y coordinates of the points.
+ * @param[in] T The list of nodes (parameters) associated to the points.
+ * @param[in] tToEval The list of parameter values to evaluate.
+ * @return the list of points of the curve.
+ */
 std::vector<Point> applyLagrangeSubdivision(const std::vector<double>& X,
                                             const std::vector<double>& Y,
                                             const std::vector<double>& T,
                                             const std::vector<double>& tToEval);
 
+/**
+ * @brief The working memory of applyLagrangeSubdivision(), so that evaluating a curve again does not allocate.
+ */
+struct LagrangeWorkspace
+{
+    /// the nodes of the cached weights
+    std::vector<double> nodes{};
+    /// the barycentric weights of the nodes, only computed again when the nodes change
+    std::vector<double> weights{};
+    /// the running products on the left of each node, for each range of parameter values evaluated concurrently
+    std::vector<double> left{};
+};
+
+/**
+ * @brief Same as applyLagrangeSubdivision(), the points being written in a list whose memory is reused.
+ * The coordinates can be read from any contiguous arrays, e.g. ControlPoints::getCoordinateArrays().
+ * @param[in,out] workspace The working memory, the weights it holds are reused while the nodes are unchanged.
+ */
+void applyLagrangeSubdivision(Span<const double> X,
+                              Span<const double> Y,
+                              const std::vector<double>& T,
+                              const std::vector<double>& tToEval,
+                              std::vector<Point>& curve,
+                              LagrangeWorkspace& workspace);
+
 std::vector<Point> applyLagrangeSubdivision(const std::vector<Point>& points,
                                             const std::vector<double>& T,
-                                            const std::vector<double>& tToEval);
\ No newline at end of file
+                                            const std::vector<double>& tToEval);
+
+/**
+ * @brief Computes the points of the parametric Lagrange curve for each parameter value using the barycentric form.
+ * Both the coordinates are accumulated at once, and the parameter values are evaluated by blocks using the SIMD
+ * registers available on the target.
+ * @param[in] X The list of x coordinates of the points.
+ * @param[in] Y The list of y coordinates of the points.
+ * @param[in] T The list of nodes (parameters) associated to the points.
+ * @param[in] W The list of barycentric weights of the nodes, as computed by barycentricWeights().
+ * @param[in] tToEval The list of parameter values to evaluate.
+ * @return the list of points of the curve.
+ */
+std::vector<Point> applyBarycentricSubdivision(const std::vector<double>& X,
+                                               const std::vector<double>& Y,
+                                               const std::vector<double>& T,
+                                               const std::vector<double>& W,
+                                               const std::vector<double>& tToEval);
+
+/**
+ * @brief Same as applyBarycentricSubdivision(), the points being written in a list whose memory is reused.
+ * The coordinates can be read from any contiguous arrays, e.g. ControlPoints::getCoordinateArrays().
+ */
+void applyBarycentricSubdivision(Span<const double> X,
+                                 Span<const double> Y,
+                                 const std::vector<double>& T,
+                                 const std::vector<double>& W,
+                                 const std::vector<double>& tToEval,
+                                 std::vector<Point>& curve);
+
+/**
+ * @brief Computes the points of the parametric Lagrange curve for each parameter value using only the k nodes closest
+ * to the value, i.e. a piecewise polynomial of degree k - 1. The window of nodes slides along the sorted nodes, so the
+ * cost of a sample is O(k) instead of O(n^2), and the high degree oscillations of the global polynomial are avoided.
+ * With k equal to the number of nodes, the curve is the one of applyBarycentricSubdivision().
+ * @param[in] X The list of x coordinates of the points.
+ * @param[in] Y The list of y coordinates of the points.
+ * @param[in] T The list of nodes, sorted in increasing or decreasing order, e.g. the Chebycheff nodes.
+ * @param[in] window The number of nodes used for each value k, all the nodes if 0 or greater than their number.
+ * @param[in] tToEval The list of parameter values to evaluate, the window slides in O(1) when they are sorted.
+ * @return the list of points of the curve.
+ */
+std::vector<Point> applyWindowedLagrangeSubdivision(const std::vector<double>& X,
+                                                    const std::vector<double>& Y,
+                                                    const std::vector<double>& T,
+                                                    std::size_t window,
+                                                    const std::vector<double>& tToEval);
+
+/**
+ * @brief Same as applyWindowedLagrangeSubdivision(), the points being written in a list whose memory is reused.
+ */
+void applyWindowedLagrangeSubdivision(Span<const double> X,
+                                      Span<const double> Y,
+                                      Span<const double> T,
+                                      std::size_t window,
+                                      const std::vector<double>& tToEval,
+                                      std::vector<Point>& curve);
+
+/**
+ * @brief Computes the points of the parametric Lagrange curve for each parameter value using its Newton form.
+ * Both the coordinates are evaluated at once, and the parameter values are evaluated by blocks using the SIMD
+ * registers available on the target.
+ * @param[in] T The list of nodes (parameters) of the Newton form.
+ * @param[in] coefficients The list of coefficients of the Newton form, i.e. the divided differences of the points.
+ * @param[in] tToEval The list of parameter values to evaluate.
+ * @return the list of points of the curve.
+ */
+std::vector<Point> applyNewtonSubdivision(const std::vector<double>& T,
+                                          const std::vector<Point>& coefficients,
+                                          const std::vector<double>& tToEval);
+
+/**
+ * @brief Same as applyNewtonSubdivision(), the points being written in a list whose memory is reused.
+ */
+void applyNewtonSubdivision(const std::vector<double>& T,
+                            const std::vector<Point>& coefficients,
+                            const std::vector<double>& tToEval,
+                            std::vector<Point>& curve);
+
+/**
+ * @brief Computes the points of the parametric Lagrange curve through points at the Chebycheff nodes for each
+ * parameter value, from its coefficients in the basis of the Chebycheff polynomials (see ChebycheffSeries). Each value
+ * is evaluated with the Clenshaw recurrence in O(n), by blocks using the SIMD registers available on the target.
+ * @param[in] coefficients The list of coefficients of T_0, ..., T_n-1.
+ * @param[in] tToEval The list of parameter values to evaluate, in [-1, 1].
+ * @return the list of points of the curve.
+ */
+std::vector<Point> applyChebycheffSubdivision(const std::vector<Point>& coefficients,
+                                              const std::vector<double>& tToEval);
+
+/**
+ * @brief Same as applyChebycheffSubdivision(), the points being written in a list whose memory is reused.
+ */
+void applyChebycheffSubdivision(const std::vector<Point>& coefficients,
+                                const std::vector<double>& tToEval,
+                                std::vector<Point>& curve);
@@ -2,6 +2,8 @@
 
 #include "parametrization.h"
 #include "Point.h"
+#include "Tracer.h"
+#include <cassert>
 #include <numeric>
 #include <algorithm>
 #include <iostream>
@@ -22,10 +24,11 @@ std::vector<double> uniformParametrization(std::size_t step)
 
 void uniformSubdivision(std::size_t nbElem, double step, std::vector<double>& T, std::vector<double>& tToEval)
 {
+    CURVES_TRACE_SCOPE("uniformSubdivision");
     T.resize(nbElem);
     std::iota(T.begin(), T.end(), .0);
 
-    tToEval = createSamples(step, T);
+    createSamples(step, T, tToEval);
 }
 
 
@@ -46,11 +49,12 @@ std::tuple<std::vector<double>, std::vector<double>> distanceSubdivision( double
     return {T, tToEval};
 }
 
-void distanceSubdivision(double step, const std::vector<Point>& points, std::vector<double>& T, std::vector<double>& tToEval)
+void distanceSubdivision(double step, Span<const Point> points, std::vector<double>& T, std::vector<double>& tToEval)
 {
-    T = computeDistanceSubdivision(points);
-
-    tToEval = createSamples(step, T);
+    CURVES_TRACE_SCOPE("distanceSubdivision");
+    T.resize(points.size());
+    computeDistanceSubdivision(points, T);
+    createSamples(step, T, tToEval);
 }
 
 std::tuple<std::vector<double>, std::vector<double>> rootDistanceSubdivision(double pas, const std::vector<Point>& points)
@@ -61,10 +65,15 @@ std::tuple<std::vector<double>, std::vector<double>> rootDistanceSubdivision(dou
     return {T, tToEval};
 }
 
-void rootDistanceSubdivision(double step, const std::vector<Point>& points, std::vector<double>& T, std::vector<double>& tToEval)
+void rootDistanceSubdivision(double step,
+                             Span<const Point> points,
+                             std::vector<double>& T,
+                             std::vector<double>& tToEval)
 {
-    T = computeRootDistanceSubdivision(points);
-    tToEval = createSamples(step, T);
+    CURVES_TRACE_SCOPE("rootDistanceSubdivision");
+    T.resize(points.size());
+    computeRootDistanceSubdivision(points, T);
+    createSamples(step, T, tToEval);
 }
 
 std::tuple<std::vector<double>, std::vector<double>> chebycheffSubdivision(double pas, const std::vector<Point>& points)
@@ -75,73 +84,142 @@ std::tuple<std::vector<double>, std::vector<double>> chebycheffSubdivision(doubl
     return {T, tToEval};
 }
 
-void chebycheffSubdivision(double step, const std::vector<Point>& points, std::vector<double>& T, std::vector<double>& tToEval)
+void chebycheffSubdivision(double step, Span<const Point> points, std::vector<double>& T, std::vector<double>& tToEval)
 {
-    T = computeChebycheffSubdivision(points);
-    tToEval = createSamples(step, T);
+    CURVES_TRACE_SCOPE("chebycheffSubdivision");
+    T.resize(points.size());
+    computeChebycheffSubdivision(points, T);
+    createSamples(step, T, tToEval);
 }
 
 
 std::vector<double> computeDistanceSubdivision(const std::vector<Point>& points)
 {
-    const auto nbElem = points.size();
-    std::vector<double> T(nbElem);
+    std::vector<double> T(points.size());
+    computeDistanceSubdivision(points, T);
+    return T;
+}
 
+void computeDistanceSubdivision(Span<const Point> points, Span<double> T)
+{
+    assert(T.size() == points.size());
+    if(T.empty())
+    {
+        return;
+    }
     T[0] = .0;
-    for(std::size_t i = 1; i < nbElem; ++i)
+    for(std::size_t i = 1; i < points.size(); ++i)
     {
         const auto d = glm::distance(points[i - 1], points[i]);
         T[i] = T[i - 1] + d;
     }
-    return T;
 }
 
 std::vector<double> computeRootDistanceSubdivision(const std::vector<Point>& points)
 {
-    const auto nbElem = points.size();
-    std::vector<double> T(nbElem);
+    std::vector<double> T(points.size());
+    computeRootDistanceSubdivision(points, T);
+    return T;
+}
 
+void computeRootDistanceSubdivision(Span<const Point> points, Span<double> T)
+{
+    assert(T.size() == points.size());
+    if(T.empty())
+    {
+        return;
+    }
     T[0] = .0;
-    for(std::size_t i = 1; i < nbElem; ++i)
+    for(std::size_t i = 1; i < points.size(); ++i)
     {
         const auto d = glm::distance(points[i - 1], points[i]);
         T[i] = T[i - 1] + std::sqrt(d);
     }
-    return T;
+}
+
+namespace {
+/**
+ * @brief Updates the nodes after a single point has been moved or appended.
+ * @param[in] points The points, after the modification.
+ * @param[in] idx The index of the modified point.
+ * @param[in,out] T The nodes.
+ * @param[in] length The function giving the increment of the nodes for the distance between two consecutive points.
+ */
+template <typename Length>
+void updateNodesAt(Span<const Point> points, std::size_t idx, Span<double> T, const Length& length)
+{
+    assert(T.size() == points.size());
+    assert(idx < points.size());
+    T[idx] = idx == 0 ? .0 : T[idx - 1] + length(glm::distance(points[idx - 1], points[idx]));
+    if(idx + 1 == points.size())
+    {
+        return;
+    }
+    const auto next = T[idx] + length(glm::distance(points[idx], points[idx + 1]));
+    const auto shift = next - T[idx + 1];
+    T[idx + 1] = next;
+    for(auto i = idx + 2; i < points.size(); ++i)
+    {
+        T[i] += shift;
+    }
+}
+}
+
+void updateDistanceSubdivision(Span<const Point> points, std::size_t idx, Span<double> T)
+{
+    updateNodesAt(points, idx, T, [](double d) { return d; });
+}
+
+void updateRootDistanceSubdivision(Span<const Point> points, std::size_t idx, Span<double> T)
+{
+    updateNodesAt(points, idx, T, [](double d) { return std::sqrt(d); });
 }
 
 std::vector<double> computeChebycheffSubdivision(const std::vector<Point>& points)
 {
-    const auto nbElem = points.size();
-    std::vector<double> T(nbElem);
+    std::vector<double> T(points.size());
+    computeChebycheffSubdivision(points, T);
+    return T;
+}
 
+void computeChebycheffSubdivision(Span<const Point> points, Span<double> T)
+{
+    assert(T.size() == points.size());
+    const auto nbElem = points.size();
     for (std::size_t i = 0; i < nbElem; ++i)
     {
         const double v = ((2 * static_cast<double>(i) + 1) * glm::pi<double>()) / static_cast<double>(2 * (nbElem - 1) + 2);
         T[i] = std::cos(v);
     }
-
-    return T;
 }
 
 std::vector<double> createSamples(double step, const std::vector<double>& T)
+{
+    std::vector<double> tToEval;
+    createSamples(step, T, tToEval);
+    return tToEval;
+}
+
+void createSamples(double step, Span<const double> T, std::vector<double>& tToEval, bool keepPrefix)
 {
     // Start value for the samples
     const auto start = *std::min_element(T.begin(), T.end());
     // End value for the samples
     const auto end =  *std::max_element(T.begin(), T.end());
     const auto numSamples = static_cast<std::size_t>((end-start) / step);
-    std::vector<double> tToEval(numSamples+1);
-
-    for(std::size_t i{0}; i < tToEval.size(); ++i)
+    // just assure that the last element is the end value, the size is known beforehand so that the buffer is only
+    // reallocated when it grows
+    const auto last = start + static_cast<double>(numSamples) * step;
+    // the previous values are start + i * step, except the last one that may have been the largest node
+    const std::size_t first = keepPrefix && !tToEval.empty() ? tToEval.size() - 1 : 0;
+    tToEval.resize(numSamples + (last < end ? 2 : 1));
+
+    for(std::size_t i{first}; i <= numSamples; ++i)
     {
         tToEval[i] = start + static_cast<double>(i) * step;
     }
-    // just assure that the last element is the end value
-    if(tToEval.back() < end)
+    if(last < end)
     {
-        tToEval.push_back(end);
+        tToEval.back() = end;
     }
-
-    return tToEval;
-}
\ No newline at end of file
+}
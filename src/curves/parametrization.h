@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Point.h"
+#include "Span.h"
 #include <vector>
 #include <tuple>
 
@@ -12,21 +13,64 @@
 std::vector<double> uniformParametrization(std::size_t step);
 
 
+/*
+ * The subdivisions compute the nodes T associated to the points and the parameter values tToEval where the curve is
+ * evaluated. The overloads taking the output vectors reuse their memory, so they do not allocate once the vectors
+ * are large enough, e.g. when the curve is computed again after a point has been moved.
+ */
 
 void uniformSubdivision(std::size_t nbElem, double step, std::vector<double>& T, std::vector<double>& tToEval);
 std::tuple<std::vector<double>, std::vector<double>> uniformSubdivision(std::size_t nbElem, double pas);
 
 std::tuple<std::vector<double>, std::vector<double>> distanceSubdivision(double pas, const std::vector<Point>& points);
-void distanceSubdivision(double step, const std::vector<Point>& points, std::vector<double>& T, std::vector<double>& tToEval);
+void distanceSubdivision(double step, Span<const Point> points, std::vector<double>& T, std::vector<double>& tToEval);
 
 std::tuple<std::vector<double>, std::vector<double>> rootDistanceSubdivision(double pas, const std::vector<Point>& points);
-void rootDistanceSubdivision(double step, const std::vector<Point>& points, std::vector<double>& T, std::vector<double>& tToEval);
+void rootDistanceSubdivision(double step,
+                             Span<const Point> points,
+                             std::vector<double>& T,
+                             std::vector<double>& tToEval);
 
 std::tuple<std::vector<double>, std::vector<double>> chebycheffSubdivision(double pas, const std::vector<Point>& points);
-void chebycheffSubdivision(double step, const std::vector<Point>& points, std::vector<double>& T, std::vector<double>& tToEval);
+void chebycheffSubdivision(double step, Span<const Point> points, std::vector<double>& T, std::vector<double>& tToEval);
 
 std::vector<double> computeDistanceSubdivision(const std::vector<Point>& points);
 std::vector<double> computeRootDistanceSubdivision(const std::vector<Point>& points);
 std::vector<double> computeChebycheffSubdivision(const std::vector<Point>& points);
 
-std::vector<double> createSamples(double step, const std::vector<double>& T);
\ No newline at end of file
+/**
+ * @brief Computes the nodes of the points into a buffer owned by the caller.
+ * @param[in] points The points.
+ * @param[out] T The nodes, it must have the size of the points.
+ */
+void computeDistanceSubdivision(Span<const Point> points, Span<double> T);
+void computeRootDistanceSubdivision(Span<const Point> points, Span<double> T);
+void computeChebycheffSubdivision(Span<const Point> points, Span<double> T);
+
+/**
+ * @brief Updates the nodes computed by computeDistanceSubdivision() after a single point has been moved or appended.
+ * Only the two distances around the point change, so the nodes following it are shifted by the same amount, in
+ * O(n - idx) operations instead of computing all the distances again.
+ * @param[in] points The points, after the modification.
+ * @param[in] idx The index of the modified point, the last one if it has been appended.
+ * @param[in,out] T The nodes of the points before the modification, resized to the number of points.
+ */
+void updateDistanceSubdivision(Span<const Point> points, std::size_t idx, Span<double> T);
+
+/**
+ * @brief Same as updateDistanceSubdivision() for the nodes computed by computeRootDistanceSubdivision().
+ */
+void updateRootDistanceSubdivision(Span<const Point> points, std::size_t idx, Span<double> T);
+
+std::vector<double> createSamples(double step, const std::vector<double>& T);
+
+/**
+ * @brief Computes the parameter values between the smallest and the largest node, reusing the memory of the output.
+ * @param[in] step The step between two parameter values.
+ * @param[in] T The nodes.
+ * @param[in,out] tToEval The parameter values, the last one being the largest node.
+ * @param[in] keepPrefix Whether tToEval holds the output of a previous call with the same step and the same smallest
+ * node, e.g. for the distance nodes that always start at 0. Only the values following the ones that are unchanged
+ * are then computed.
+ */
+void createSamples(double step, Span<const double> T, std::vector<double>& tToEval, bool keepPrefix = false);
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "sampling.h"
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+/// the settings shared by all the intervals of a sampling
+struct FunctionSampling
+{
+    const std::function<double(double)>& f;
+    const Viewport& viewport;
+    double tolerance;
+};
+
+/**
+ * @return how far the three points are above or below the viewport, 0 if one of them is not
+ */
+double distanceOutside(const Viewport& viewport, const Point& a, const Point& m, const Point& b)
+{
+    const auto below = viewport.ymin - std::max({a.y, m.y, b.y});
+    const auto above = std::min({a.y, m.y, b.y}) - viewport.ymax;
+    return std::max({below, above, 0.});
+}
+
+/**
+ * Splits the interval [a, b] of the graph until it is flat, the points after a being added to out.
+ */
+void refine(const FunctionSampling& sampling, const Point& a, const Point& b, unsigned depth, std::vector<Point>& out)
+{
+    const auto x = (a.x + b.x) / 2.;
+    const Point m{x, sampling.f(x)};
+    // the distance between the middle point of the graph and the chord
+    const auto chord = b - a;
+    const auto deviation = std::abs(chord.x * (m.y - a.y) - chord.y * (m.x - a.x)) / glm::length(chord);
+    if(depth > 0 && deviation > sampling.tolerance &&
+       distanceOutside(sampling.viewport, a, m, b) <= std::abs(m.y - (a.y + b.y) / 2.))
+    {
+        refine(sampling, a, m, depth - 1, out);
+        refine(sampling, m, b, depth - 1, out);
+        return;
+    }
+    out.push_back(b);
+}
+
+/**
+ * @return the distance between the point and the segment [a, b]
+ */
+double distanceToChord(const Point& p, const Point& a, const Point& b)
+{
+    const auto chord = b - a;
+    const auto squaredLength = glm::dot(chord, chord);
+    // a loop of the curve can bring both ends of the interval together
+    const auto t = squaredLength > 0 ? std::clamp(glm::dot(p - a, chord) / squaredLength, 0., 1.) : 0.;
+    return glm::distance(p, a + t * chord);
+}
+}
+
+void adaptiveFunctionSampling(const std::function<double(double)>& f,
+                              double xmin,
+                              double xmax,
+                              const Viewport& viewport,
+                              double tolerance,
+                              std::vector<Point>& out,
+                              std::size_t initialSegments,
+                              unsigned maxDepth)
+{
+    CURVES_TRACE_SCOPE("adaptiveFunctionSampling");
+    out.clear();
+    const auto start = std::max(xmin, viewport.xmin);
+    const auto end = std::min(xmax, viewport.xmax);
+    if(!(start <= end))
+    {
+        return;
+    }
+    const FunctionSampling sampling{f, viewport, tolerance};
+    const auto segments = std::max<std::size_t>(initialSegments, 1);
+    const auto length = (end - start) / static_cast<double>(segments);
+    Point previous{start, f(start)};
+    out.push_back(previous);
+    for(std::size_t i{1}; i <= segments; ++i)
+    {
+        const auto x = i == segments ? end : start + static_cast<double>(i) * length;
+        const Point next{x, f(x)};
+        refine(sampling, previous, next, maxDepth, out);
+        previous = next;
+    }
+}
+
+void adaptiveCurveSampling(const CurveEvaluator& evaluate,
+                           Span<const double> T,
+                           double tolerance,
+                           std::size_t maxVertices,
+                           std::vector<double>& tToEval,
+                           std::vector<Point>& curve,
+                           CurveSamplingWorkspace& workspace,
+                           unsigned maxDepth)
+{
+    CURVES_TRACE_SCOPE("adaptiveCurveSampling");
+    tToEval.assign(T.begin(), T.end());
+    std::sort(tToEval.begin(), tToEval.end());
+    evaluate(tToEval, curve);
+    if(tToEval.size() < 2)
+    {
+        return;
+    }
+    auto& [middles, middlePoints, intervals, deviations, done, nextT, nextPoints, nextDone] = workspace;
+    done.assign(tToEval.size() - 1, 0);
+    for(unsigned depth = 0; depth < maxDepth; ++depth)
+    {
+        middles.clear();
+        intervals.clear();
+        for(std::size_t i{0}; i < done.size(); ++i)
+        {
+            if(done[i] == 0)
+            {
+                middles.push_back((tToEval[i] + tToEval[i + 1]) / 2.);
+                intervals.push_back(i);
+            }
+        }
+        if(middles.empty())
+        {
+            return;
+        }
+        evaluate(middles, middlePoints);
+        deviations.resize(middles.size());
+        std::size_t nbSplits{0};
+        for(std::size_t j{0}; j < middles.size(); ++j)
+        {
+            const auto i = intervals[j];
+            deviations[j] = distanceToChord(middlePoints[j], curve[i], curve[i + 1]);
+            if(deviations[j] > tolerance)
+            {
+                ++nbSplits;
+            }
+            else
+            {
+                done[i] = 1;
+            }
+        }
+        // when the budget is too small for all the splits, only the intervals farthest from their chord are split
+        const auto budget = maxVertices > tToEval.size() ? maxVertices - tToEval.size() : 0;
+        const auto capped = nbSplits > budget;
+        auto threshold = tolerance;
+        std::size_t ties{0};
+        if(capped && budget > 0)
+        {
+            nextT.clear();
+            std::copy_if(deviations.begin(), deviations.end(), std::back_inserter(nextT), [tolerance](double d) {
+                return d > tolerance;
+            });
+            const auto kth = nextT.begin() + static_cast<std::ptrdiff_t>(budget - 1);
+            std::nth_element(nextT.begin(), kth, nextT.end(), std::greater<>());
+            // the splits above the budget-th largest deviation, then as many of its ties as the budget allows
+            threshold = *kth;
+            ties = budget - static_cast<std::size_t>(std::count_if(
+                                nextT.begin(), nextT.end(), [threshold](double d) { return d > threshold; }));
+        }
+        const auto split = [&](std::size_t j) {
+            if(!(deviations[j] > tolerance) || (capped && budget == 0) || deviations[j] < threshold)
+            {
+                return false;
+            }
+            if(deviations[j] > threshold)
+            {
+                return true;
+            }
+            // a tie with the budget-th largest deviation
+            if(ties == 0)
+            {
+                return false;
+            }
+            --ties;
+            return true;
+        };
+        nextT.clear();
+        nextPoints.clear();
+        nextDone.clear();
+        std::size_t j{0};
+        for(std::size_t i{0}; i < done.size(); ++i)
+        {
+            nextT.push_back(tToEval[i]);
+            nextPoints.push_back(curve[i]);
+            if(j < intervals.size() && intervals[j] == i)
+            {
+                if(split(j))
+                {
+                    nextT.push_back(middles[j]);
+                    nextPoints.push_back(middlePoints[j]);
+                    nextDone.push_back(0);
+                }
+                ++j;
+            }
+            nextDone.push_back(done[i]);
+        }
+        nextT.push_back(tToEval.back());
+        nextPoints.push_back(curve.back());
+        std::swap(tToEval, nextT);
+        std::swap(curve, nextPoints);
+        std::swap(done, nextDone);
+        if(capped)
+        {
+            return;
+        }
+    }
+}
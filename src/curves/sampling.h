@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Point.h"
+#include "Span.h"
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+/// an axis-aligned rectangle of the plane, e.g. the visible part of the window, the whole plane by default
+struct Viewport
+{
+    double xmin{-std::numeric_limits<double>::infinity()};
+    double ymin{-std::numeric_limits<double>::infinity()};
+    double xmax{std::numeric_limits<double>::infinity()};
+    double ymax{std::numeric_limits<double>::infinity()};
+};
+
+/**
+ * Samples the graph of a function y = f(x) with as few points as needed to stay within a distance tolerance from it.
+ * The range is first split into initialSegments intervals, then each interval is split in two halves until the middle
+ * point of the graph is within the tolerance from the chord of the interval. The range is clipped to the horizontal
+ * extent of the viewport, and the intervals lying above or below the viewport are not split further when the graph is
+ * farther from the viewport than from its chord, so the parts leaving the screen only get the points joining them.
+ * @param f The function, evaluated once per point of the graph
+ * @param xmin The lower bound of the range of x
+ * @param xmax The upper bound of the range of x
+ * @param viewport The visible part of the plane
+ * @param tolerance The maximum distance between the graph and the polyline, e.g. in pixels
+ * @param out The points of the polyline, by increasing x, empty if the range and the viewport do not overlap
+ * @param initialSegments The number of intervals before the refinement, features narrower than them can be missed
+ * @param maxDepth The maximum number of splits of an initial interval
+ */
+void adaptiveFunctionSampling(const std::function<double(double)>& f,
+                              double xmin,
+                              double xmax,
+                              const Viewport& viewport,
+                              double tolerance,
+                              std::vector<Point>& out,
+                              std::size_t initialSegments = 32,
+                              unsigned maxDepth = 12);
+
+/// evaluates a curve at each of the parameter values, the points being written in a list whose memory is reused
+using CurveEvaluator = std::function<void(const std::vector<double>& tToEval, std::vector<Point>& curve)>;
+
+/// the working memory of adaptiveCurveSampling(), kept so that sampling again does not allocate
+struct CurveSamplingWorkspace
+{
+    /// the middle parameter values of the intervals tested at the current level, and their points
+    std::vector<double> middles{};
+    std::vector<Point> middlePoints{};
+    /// the index of the interval of each middle value
+    std::vector<std::size_t> intervals{};
+    /// the distances between the middle points and the chords
+    std::vector<double> deviations{};
+    /// whether each interval is flat enough, or at the maximum depth
+    std::vector<char> done{};
+    /// the sampling being built for the next level
+    std::vector<double> nextT{};
+    std::vector<Point> nextPoints{};
+    std::vector<char> nextDone{};
+};
+
+/**
+ * Samples a parametric curve with as few points as needed to stay within a distance tolerance from it. The sampling
+ * starts from the nodes, then the intervals between two consecutive parameter values are split in two halves, level
+ * by level, until the middle point of each interval is within the tolerance from its chord. All the middle points of
+ * a level are evaluated at once, so the evaluation can use the vectorized and multithreaded kernels. When splitting
+ * all the remaining intervals would exceed the maximum number of vertices, only the ones farthest from their chord are
+ * split, and the refinement stops.
+ * @param evaluate The evaluation of the curve
+ * @param T The nodes of the curve, in any order, the curve is sampled from the smallest to the largest one
+ * @param tolerance The maximum distance between the curve and the polyline, e.g. in pixels
+ * @param maxVertices The maximum number of points of the polyline, the nodes are always kept
+ * @param tToEval The parameter values of the points, increasing
+ * @param curve The points of the polyline
+ * @param workspace The working memory
+ * @param maxDepth The maximum number of splits of an interval between two nodes
+ */
+void adaptiveCurveSampling(const CurveEvaluator& evaluate,
+                           Span<const double> T,
+                           double tolerance,
+                           std::size_t maxVertices,
+                           std::vector<double>& tToEval,
+                           std::vector<Point>& curve,
+                           CurveSamplingWorkspace& workspace,
+                           unsigned maxDepth = 16);
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CURVES_SIMD_SSE2
+#endif
+
+/**
+ * Minimal abstraction over a register of doubles used by the evaluation kernels to process a block of parameter
+ * values at once. It maps to AVX2 (4 lanes) when the library is compiled with CURVES_ENABLE_AVX2, to SSE2 (2 lanes)
+ * on the other x86 targets, and to a plain double (1 lane) elsewhere. The aligned loads need an address aligned on
+ * the size of the register, e.g. in the arrays of CoordinateArrays.
+ */
+namespace simd {
+
+#if defined(__AVX2__)
+
+struct Pack
+{
+    static constexpr std::size_t size{4};
+    __m256d v;
+
+    static Pack broadcast(double a) { return {_mm256_set1_pd(a)}; }
+    static Pack load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    static Pack loadAligned(const double* p) { return {_mm256_load_pd(p)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm256_div_pd(a.v, b.v)}; }
+};
+
+/// @return a bit mask with the i-th bit set if the i-th lane is zero
+inline int zeroMask(Pack a) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v, _mm256_setzero_pd(), _CMP_EQ_OQ)); }
+
+/// @return a bit mask with the i-th bit set if the i-th lane of a is lower than or equal to the one of b
+inline int lessEqualMask(Pack a, Pack b) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)); }
+
+inline Pack sqrt(Pack a) { return {_mm256_sqrt_pd(a.v)}; }
+
+#elif defined(CURVES_SIMD_SSE2)
+
+struct Pack
+{
+    static constexpr std::size_t size{2};
+    __m128d v;
+
+    static Pack broadcast(double a) { return {_mm_set1_pd(a)}; }
+    static Pack load(const double* p) { return {_mm_loadu_pd(p)}; }
+    static Pack loadAligned(const double* p) { return {_mm_load_pd(p)}; }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm_add_pd(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm_sub_pd(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm_mul_pd(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm_div_pd(a.v, b.v)}; }
+};
+
+/// @return a bit mask with the i-th bit set if the i-th lane is zero
+inline int zeroMask(Pack a) { return _mm_movemask_pd(_mm_cmpeq_pd(a.v, _mm_setzero_pd())); }
+
+/// @return a bit mask with the i-th bit set if the i-th lane of a is lower than or equal to the one of b
+inline int lessEqualMask(Pack a, Pack b) { return _mm_movemask_pd(_mm_cmple_pd(a.v, b.v)); }
+
+inline Pack sqrt(Pack a) { return {_mm_sqrt_pd(a.v)}; }
+
+#else
+
+struct Pack
+{
+    static constexpr std::size_t size{1};
+    double v;
+
+    static Pack broadcast(double a) { return {a}; }
+    static Pack load(const double* p) { return {*p}; }
+    static Pack loadAligned(const double* p) { return {*p}; }
+    void store(double* p) const { *p = v; }
+
+    friend Pack operator+(Pack a, Pack b) { return {a.v + b.v}; }
+    friend Pack operator-(Pack a, Pack b) { return {a.v - b.v}; }
+    friend Pack operator*(Pack a, Pack b) { return {a.v * b.v}; }
+    friend Pack operator/(Pack a, Pack b) { return {a.v / b.v}; }
+};
+
+/// @return a bit mask with the i-th bit set if the i-th lane is zero
+inline int zeroMask(Pack a) { return std::fpclassify(a.v) == FP_ZERO ? 1 : 0; }
+
+/// @return a bit mask with the i-th bit set if the i-th lane of a is lower than or equal to the one of b
+inline int lessEqualMask(Pack a, Pack b) { return a.v <= b.v ? 1 : 0; }
+
+inline Pack sqrt(Pack a) { return {std::sqrt(a.v)}; }
+
+#endif
+
+}
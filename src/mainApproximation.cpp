@@ -1,8 +1,15 @@
+#include "AllocationCounter.h"
 #include "Camera.h"
+#include <curves/AsyncCurve.h>
 #include <curves/BezierCurve.h>
 #include <curves/ControlPoints.h>
+#include <curves/ThreadPool.h>
+#include <curves/Tracer.h>
 
 #include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
 
 // for mac osx
 #ifdef __APPLE__
@@ -25,7 +32,16 @@ using namespace std;
  * Utils
  */
 Camera* camera;
-std::unique_ptr<BezierCurve> inter;
+/// the curve, computed on a background thread while the input is handled
+std::unique_ptr<AsyncCurve<BezierCurve, std::vector<Point>>> inter;
+/// the control points edited by the input, in sync with the ones of the curve, to pick and draw them at once
+ControlPoints controlPoints;
+/// the way the curve is sampled
+BezierCurve::Tessellation tessellation{BezierCurve::Tessellation::Uniform};
+/// the version of the curve last displayed
+std::uint64_t drawnVersion{0};
+/// the delay between two checks of a new version of the curve, in milliseconds
+unsigned pollingDelay{10};
 bool track{false};
 std::size_t draggedPointIdx;
 /*
@@ -43,20 +59,76 @@ GLdouble controlColor[3] = {0.0, 0.0, 1.0};
 GLclampf backColor[3] = {1.0, 1.0, 1.0};
 /// threshold for clicking distance
 double clickThresh{50.0};
+/// file where the trace of the curves library is saved
+const char* traceFilename{"curvetool_trace.json"};
 /// segments per Bezier curve
 std::size_t steps{100};
 
+/**
+ * Copies the points of the curve, on the background thread
+ * @param curve The curve
+ * @param points The points to display, their memory is reused
+ */
+void buildCurve(const BezierCurve& curve, std::vector<Point>& points)
+{
+    const auto& curvePoints = curve.getCurvePoint();
+    points.assign(curvePoints.begin(), curvePoints.end());
+}
+
+/**
+ * Redisplays the curve when the background thread has computed a new version
+ */
+void poll(int)
+{
+    if(inter->version() != drawnVersion)
+    {
+        glutPostRedisplay();
+    }
+    glutTimerFunc(pollingDelay, poll, 0);
+}
+
+/**
+ * @return the last computed curve, the errors of the background thread being reported on the standard error
+ */
+std::shared_ptr<const std::vector<Point>> latestSnapshot()
+{
+    try
+    {
+        return inter->snapshot();
+    }
+    catch(const std::exception& e)
+    {
+        // the worker has dropped the rest of the failed batch, its curve is set again from the points shown here so
+        // that the indices of the next edits designate the same points, the previous curve being drawn meanwhile
+        std::cerr << "Error while computing the curve: " << e.what() << std::endl;
+        inter->edit([points = controlPoints.getControlPoints(), mode = tessellation](BezierCurve& curve) {
+            curve.setTessellation(mode);
+            curve.setControlPoints(points);
+        });
+        return inter->snapshot();
+    }
+}
+
+/**
+ * Stops the background thread, called by exit() whether the user quits or closes the window.
+ */
+void stopWorker() { inter.reset(); }
+
 /**
  * The rendering function
  */
 void draw()
 {
+    CURVES_TRACE_SCOPE("draw");
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // the last computed curve, possibly a few events behind the control points
+    drawnVersion = inter->version();
+    const auto curve = latestSnapshot();
     // drawing the bounding box
     glBegin(GL_LINE_STRIP);
     glColor3d(controlColor[0], controlColor[1], controlColor[2]);
     //    for(const auto& point : bezierCurve->controlPoints)
-    for(const auto& point : inter->getControlPoints())
+    for(const auto& point : controlPoints.getControlPoints())
         glVertex2d(point.x, point.y);
     glEnd();
     glPointSize(5.f);
@@ -65,14 +137,14 @@ void draw()
     glBegin(GL_POINTS);
     glColor3d(controlColor[0], controlColor[1], controlColor[2]);
     //    for(const auto& point : bezierCurve->controlPoints)
-    for(const auto& point : inter->getControlPoints())
+    for(const auto& point : controlPoints.getControlPoints())
         glVertex2d(point.x, point.y);
     glEnd();
 
     // drawing the curve
     glBegin(GL_LINE_STRIP);
     glColor3d(curveColor[0], curveColor[1], curveColor[2]);
-    for(const auto& point : inter->getCurvePoint())
+    for(const auto& point : *curve)
         glVertex2d(point.x, point.y);
     glEnd();
     glutSwapBuffers();
@@ -90,15 +162,23 @@ void mouseClick(int button, int state, int x, int y)
     Point n{(double)x, window_height - (double)y};
     if(button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) // addition
     {
-        inter->add(n);
+        controlPoints.add(n);
+        inter->edit([n](BezierCurve& curve) { curve.add(n); });
     }
     else if(button == GLUT_MIDDLE_BUTTON && state == GLUT_DOWN)
     {
-        inter->deleteControlPoint(n, clickThresh);
+        // the point is picked once, both sets of points being the same its index is the same in the curve
+        const auto res = controlPoints.getIndexClosestPoint(n, clickThresh);
+        if(res.has_value())
+        {
+            const auto idx = res.value();
+            controlPoints.deleteControlPointAtIndex(idx);
+            inter->edit([idx](BezierCurve& curve) { curve.deleteControlPointAtIndex(idx); });
+        }
     }
     else if(button == GLUT_RIGHT_BUTTON && state == GLUT_DOWN) // start tracking mouse for dragging
     {
-        const auto res = inter->getIndexClosestPoint(n, clickThresh);
+        const auto res = controlPoints.getIndexClosestPoint(n, clickThresh);
         if(res.has_value())
         {
             track = true;
@@ -119,13 +199,41 @@ void mouseClick(int button, int state, int x, int y)
  */
 void mouseMove(int x, int y)
 {
+    CURVES_TRACE_SCOPE("mouseMove");
     if(!track)
         return;
     Point p = {(double)x, window_height - (double)y};
-    inter->updateControlPointAtIndex(draggedPointIdx, p, clickThresh);
+    // the control points follow the mouse at once, the curve once the background thread has computed it
+    controlPoints.updateControlPointAtIndex(draggedPointIdx, p, clickThresh);
+    inter->move(draggedPointIdx, p);
     glutPostRedisplay();
 }
 
+/**
+ * Starts recording the hot paths of the curves library, or stops recording and saves the trace
+ */
+void toggleTracing()
+{
+    auto& tracer = Tracer::instance();
+    if(!Tracer::isAvailable())
+    {
+        std::cout << "Tracing is not available, configure with -DCURVES_ENABLE_TRACING=ON" << std::endl;
+        return;
+    }
+    if(!tracer.isEnabled())
+    {
+        tracer.clear();
+        tracer.setEnabled(true);
+        std::cout << "Tracing started" << std::endl;
+        return;
+    }
+    tracer.setEnabled(false);
+    if(tracer.write(traceFilename))
+    {
+        std::cout << "Trace saved in " << traceFilename << std::endl;
+    }
+}
+
 /**
  * Handles key presses
  * @param key the keyboard input given by the user
@@ -136,7 +244,16 @@ void keyPress(unsigned char key, int, int)
 {
     switch(key)
     {
-        case 'r': inter->reset(); break;
+        case 'r':
+            controlPoints.reset();
+            inter->edit([](BezierCurve& curve) { curve.reset(); });
+            break;
+        case 'a':
+            tessellation = tessellation == BezierCurve::Tessellation::Uniform ? BezierCurve::Tessellation::Adaptive
+                                                                              : BezierCurve::Tessellation::Uniform;
+            inter->edit([mode = tessellation](BezierCurve& curve) { curve.setTessellation(mode); });
+            break;
+        case 'x': toggleTracing(); break;
         case 'q': exit(EXIT_SUCCESS);
         default: break;
     }
@@ -157,16 +274,26 @@ void initGlut()
     glutInitWindowSize(window_width, window_height);
     glutCreateWindow("Bezier");
     camera = new Camera(window_width, window_height);
-    inter = std::make_unique<BezierCurve>(steps);
+    inter = std::make_unique<AsyncCurve<BezierCurve, std::vector<Point>>>(std::make_unique<BezierCurve>(steps),
+                                                                          &buildCurve);
+    // the worker may be using the thread pool of the library, which is destroyed with the other statics by exit(): the
+    // pool is created before registering the handler stopping the worker so that it is destroyed after it
+    ThreadPool::instance();
+    std::atexit(stopWorker);
     glClearColor(backColor[0], backColor[1], backColor[2], 0);
     glutMouseFunc(mouseClick);
     glutMotionFunc(mouseMove);
     glutKeyboardFunc(keyPress);
     glutReshapeFunc(reshape);
+    glutTimerFunc(pollingDelay, poll, 0);
 }
 
 int main(int, char**)
 {
+#ifdef CURVES_ENABLE_TRACING
+    // the allocations of the traced scopes are counted by the allocation functions of AllocationCounter.cpp
+    Tracer::setAllocationCounter(threadAllocationCount);
+#endif
     initGlut();
     glutDisplayFunc(draw);
     glutMainLoop();
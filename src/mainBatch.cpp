@@ -0,0 +1,555 @@
+#include <curves/approximation.h>
+#include <curves/InterpolationCurve.h>
+#include <curves/parametrization.h>
+#include <curves/PointSetFile.h>
+#include <curves/Span.h>
+#include <curves/CubicSpline.h>
+#include <curves/ThreadPool.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Evaluates the curves of the point sets stored in text files or in binary point-set files, without any display.
+ * In a text file, a point set is a list of lines "x y", the sets being separated by blank lines; the lines starting
+ * with '#' are comments. The curves of each set are written in the same format, each one preceded by a comment giving
+ * the index of the set, the name of the curve and its number of points, or in a binary point-set file. The curves
+ * that cannot be evaluated, e.g. the interpolations of the sets of less than two points, are written empty.
+ */
+
+namespace {
+/// the extension of the binary point-set files
+constexpr const char* pointSetExtension{".cpts"};
+
+/// the flags of the Bezier curve and of the spline, next to the flags of InterpolationCurve::Curves
+constexpr unsigned bezierCurve{1U << 8U};
+constexpr unsigned splineCurve{1U << 9U};
+
+struct Evaluator
+{
+    const char* name;
+    unsigned flag;
+};
+
+constexpr Evaluator evaluators[]{{"bezier", bezierCurve},
+                                 {"functional", InterpolationCurve::Functional},
+                                 {"uniform", InterpolationCurve::Uniform},
+                                 {"distance", InterpolationCurve::Distance},
+                                 {"root-distance", InterpolationCurve::RootDistance},
+                                 {"chebycheff", InterpolationCurve::Chebycheff},
+                                 {"spline", splineCurve}};
+
+struct Options
+{
+    /// the curves to evaluate, as a combination of Evaluator flags
+    unsigned curves{InterpolationCurve::AllCurves | bezierCurve | splineCurve};
+    /// the number of steps of the Bezier curves
+    std::size_t steps{100};
+    /// the step between two parameter values of the interpolation curves
+    double step{.01};
+    /// whether the curves are written in a binary point-set file
+    bool binary{false};
+    /// the directory where the curves are written
+    std::filesystem::path outputDirectory{"."};
+    /// the files of point sets
+    std::vector<std::string> inputs{};
+};
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options] <file>...\n"
+              << "Evaluates the curves of the point sets of each file, the files being processed concurrently.\n"
+              << "The files are text files, or binary point-set files if their extension is .cpts.\n"
+              << "Each file <name>.<ext> gives a file <name>.curves.txt in the output directory, the files must\n"
+              << "have different names.\n\n"
+              << "Options:\n"
+              << "  -c, --curves <list>   comma separated list of curves among bezier, functional, uniform,\n"
+              << "                        distance, root-distance, chebycheff, spline (default: all)\n"
+              << "  -n, --steps <n>       number of steps of the Bezier curves (default: 100)\n"
+              << "  -s, --step <step>     step between two parameter values of the interpolation curves and of the\n"
+              << "                        spline, relative to the x range for the functional curve (default: 0.01)\n"
+              << "  -b, --binary          write the curves in a binary point-set file <name>.curves.cpts, the tag of\n"
+              << "                        each curve being 256 times the index of its set plus the index of the\n"
+              << "                        curve in the list above\n"
+              << "  -o, --output <dir>    output directory (default: current directory)\n"
+              << "  -h, --help            print this help\n";
+}
+
+unsigned parseCurves(const std::string& list)
+{
+    unsigned curves{0};
+    std::istringstream is(list);
+    std::string name;
+    while(std::getline(is, name, ','))
+    {
+        const auto* evaluator = std::find_if(std::begin(evaluators), std::end(evaluators),
+                                             [&name](const auto& e) { return name == e.name; });
+        if(evaluator == std::end(evaluators))
+        {
+            throw std::invalid_argument("Unknown curve " + name);
+        }
+        curves |= evaluator->flag;
+    }
+    return curves;
+}
+
+/**
+ * @return the file where the curves of an input file are written
+ */
+std::filesystem::path outputPath(const Options& options, const std::string& input)
+{
+    auto filename = options.outputDirectory / std::filesystem::path(input).stem();
+    filename += options.binary ? ".curves" + std::string(pointSetExtension) : ".curves.txt";
+    return filename;
+}
+
+/**
+ * @return the options given on the command line, or nothing if the program must exit, e.g. after printing the help
+ */
+std::optional<Options> parseArguments(int argc, char** argv)
+{
+    Options options;
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg{argv[i]};
+        const auto value = [&]() -> std::string {
+            if(i + 1 >= argc)
+            {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if(arg == "-h" || arg == "--help")
+        {
+            printUsage(argv[0]);
+            return {};
+        }
+        if(arg == "-c" || arg == "--curves")
+        {
+            options.curves = parseCurves(value());
+        }
+        else if(arg == "-n" || arg == "--steps")
+        {
+            options.steps = std::stoul(value());
+        }
+        else if(arg == "-s" || arg == "--step")
+        {
+            options.step = std::stod(value());
+            if(!(options.step > 0))
+            {
+                throw std::invalid_argument("The step must be positive");
+            }
+        }
+        else if(arg == "-b" || arg == "--binary")
+        {
+            options.binary = true;
+        }
+        else if(arg == "-o" || arg == "--output")
+        {
+            options.outputDirectory = value();
+        }
+        else if(!arg.empty() && arg[0] == '-')
+        {
+            throw std::invalid_argument("Unknown option " + arg);
+        }
+        else
+        {
+            options.inputs.push_back(arg);
+        }
+    }
+    if(options.inputs.empty())
+    {
+        throw std::invalid_argument("No input file");
+    }
+    // the files are processed concurrently, two of them must not be written to the same output
+    std::map<std::filesystem::path, std::string> outputs;
+    for(const auto& input : options.inputs)
+    {
+        const auto [output, inserted] = outputs.emplace(outputPath(options, input).lexically_normal(), input);
+        if(!inserted)
+        {
+            throw std::invalid_argument(output->second + " and " + input + " would both be written to " +
+                                        output->first.string());
+        }
+    }
+    return options;
+}
+
+/**
+ * Reads the point sets of a text file one at a time.
+ */
+class TextSource
+{
+public:
+    explicit TextSource(const std::string& filename) : is(filename)
+    {
+        if(!is)
+        {
+            throw std::runtime_error("cannot open the file");
+        }
+    }
+
+    /**
+     * Reads the next point set.
+     * @param points The points of the set, valid until the next call
+     * @return false if there is no more set
+     */
+    bool next(Span<const Point>& points)
+    {
+        buffer.clear();
+        std::string line;
+        while(std::getline(is, line))
+        {
+            ++lineNumber;
+            const auto first = line.find_first_not_of(" \t\r");
+            if(first == std::string::npos)
+            {
+                if(!buffer.empty())
+                {
+                    break;
+                }
+                continue;
+            }
+            if(line[first] == '#')
+            {
+                continue;
+            }
+            const char* begin = line.c_str() + first;
+            char* end{nullptr};
+            const auto x = std::strtod(begin, &end);
+            const auto* yBegin = end;
+            const auto y = std::strtod(yBegin, &end);
+            if(end == yBegin || yBegin == begin)
+            {
+                throw std::runtime_error("line " + std::to_string(lineNumber) + ": expected two coordinates");
+            }
+            buffer.emplace_back(x, y);
+        }
+        points = buffer;
+        return !buffer.empty();
+    }
+
+private:
+    std::ifstream is;
+    std::vector<Point> buffer;
+    /// the number of lines read so far, for the error messages
+    std::size_t lineNumber{0};
+};
+
+/**
+ * Reads the point sets of a binary point-set file one at a time, the points being used in place when they are stored
+ * as doubles.
+ */
+class BinarySource
+{
+public:
+    explicit BinarySource(const std::string& filename) : file(filename) { }
+
+    /**
+     * Reads the next point set.
+     * @param points The points of the set, valid until the next call
+     * @return false if there is no more set
+     */
+    bool next(Span<const Point>& points)
+    {
+        if(idx == file.size())
+        {
+            return false;
+        }
+        if(file.getScalar() == PointSetScalar::Float64)
+        {
+            points = file.points(idx++);
+            return true;
+        }
+        file.read(idx++, buffer);
+        points = buffer;
+        return true;
+    }
+
+private:
+    PointSetFile file;
+    std::size_t idx{0};
+    std::vector<Point> buffer;
+};
+
+/**
+ * Writes the curves in a text file, or in a binary point-set file where the tag of each curve is the index of its set
+ * times 256 plus the index of the curve in the list of curves of the help.
+ */
+class Output
+{
+public:
+    Output(const std::filesystem::path& p_filename, bool isBinary) : filename(p_filename)
+    {
+        if(isBinary)
+        {
+            binary = std::make_unique<PointSetWriter>(filename.string());
+            return;
+        }
+        text.open(filename);
+        if(!text)
+        {
+            throw std::runtime_error("cannot write " + filename.string());
+        }
+    }
+
+    void write(std::size_t setIndex, std::size_t curve, Span<const Point> points)
+    {
+        if(binary)
+        {
+            binary->write(points, (setIndex << 8U) | curve);
+            return;
+        }
+        text << "# " << setIndex << ' ' << evaluators[curve].name << ' ' << points.size() << '\n';
+        // the shortest representations that are read back as the same values, much faster than the stream formatting
+        std::array<char, 64> buffer{};
+        for(const auto& p : points)
+        {
+            auto* end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), p.x).ptr;
+            *end++ = ' ';
+            end = std::to_chars(end, buffer.data() + buffer.size(), p.y).ptr;
+            *end++ = '\n';
+            text.write(buffer.data(), end - buffer.data());
+        }
+        text << '\n';
+    }
+
+    void finish()
+    {
+        if(binary)
+        {
+            binary->finish();
+            return;
+        }
+        text.close();
+        if(!text)
+        {
+            throw std::runtime_error("error while writing " + filename.string());
+        }
+    }
+
+    /// removes the file, e.g. after an error
+    void discard()
+    {
+        binary.reset();
+        text.close();
+        std::filesystem::remove(filename);
+    }
+
+private:
+    std::filesystem::path filename;
+    std::ofstream text;
+    std::unique_ptr<PointSetWriter> binary;
+};
+
+/**
+ * Evaluates the curves of the point sets of a source, one set at a time.
+ * @return the number of point sets
+ */
+template <typename Source>
+std::size_t processPointSets(const Options& options, Source& source, Output& output)
+{
+    // the Bezier curves and the splines are evaluated straight from the points of the source
+    const auto parameters = uniformParametrization(options.steps);
+    std::vector<Point> bezier(parameters.size());
+    std::vector<Point> workspace;
+    CubicSpline<Point> spline;
+    std::vector<double> nodes;
+    std::vector<double> samples;
+    std::vector<Point> splinePoints;
+    std::vector<Point> distinctPoints;
+    std::vector<double> abscissas;
+    Span<const Point> points;
+    std::size_t setIndex{0};
+    for(; source.next(points); ++setIndex)
+    {
+        if((options.curves & bezierCurve) != 0)
+        {
+            // a binary file may hold empty sets, whose curves are empty
+            if(points.empty())
+            {
+                output.write(setIndex, 0, {});
+            }
+            else
+            {
+                deCasteljau(points, parameters, bezier, workspace);
+                output.write(setIndex, 0, bezier);
+            }
+        }
+        if((options.curves & splineCurve) != 0)
+        {
+            // the natural spline parametrized by the length of the control polygon, meant for large sets
+            splinePoints.clear();
+            nodes.resize(points.size());
+            computeDistanceSubdivision(points, nodes);
+            // the duplicated consecutive points of the set have the same node, the spline passes through them once
+            const auto through = mergeRepeatedNodes(nodes, points, distinctPoints);
+            if(nodes.size() > 1)
+            {
+                spline.build(nodes, through);
+                createSamples(options.step, nodes, samples);
+                CubicSpline<Point>::Cursor cursor(spline, samples.front());
+                for(const auto t : samples)
+                {
+                    splinePoints.push_back(cursor(t));
+                }
+            }
+            output.write(setIndex, 6, splinePoints);
+        }
+        const auto interpolationCurves = options.curves & InterpolationCurve::AllCurves;
+        if(interpolationCurves == 0)
+        {
+            continue;
+        }
+        if(points.size() < 2)
+        {
+            // at least two points are needed to get an interpolation curve
+            for(std::size_t curve{0}; curve < std::size(evaluators); ++curve)
+            {
+                if((interpolationCurves & evaluators[curve].flag) != 0)
+                {
+                    output.write(setIndex, curve, {});
+                }
+            }
+            continue;
+        }
+        const auto [xMin, xMax] = std::minmax_element(points.begin(), points.end(),
+                                                      [](const Point& a, const Point& b) { return a.x < b.x; });
+        const auto functionalStep = std::max(xMax->x - xMin->x, std::numeric_limits<double>::min()) * options.step;
+        // the functional curve is sampled along x, with the same number of samples on any range, the same curve then
+        // samples the parametric curves with the step of their parameter
+        InterpolationCurve interpolation({xMin->x, xMax->x, functionalStep});
+        for(const auto& p : points)
+        {
+            interpolation.add(p);
+        }
+        if((interpolationCurves & InterpolationCurve::Functional) != 0)
+        {
+            // the functional curve is a function of x, it is left empty if two points have the same x
+            abscissas.clear();
+            for(const auto& p : points)
+            {
+                abscissas.push_back(p.x);
+            }
+            std::sort(abscissas.begin(), abscissas.end());
+            if(std::adjacent_find(abscissas.begin(), abscissas.end()) == abscissas.end())
+            {
+                output.write(setIndex, 1, interpolation.getFunctionalCurve());
+            }
+            else
+            {
+                output.write(setIndex, 1, {});
+            }
+        }
+        interpolation.setParameters({xMin->x, xMax->x, options.step});
+        interpolation.update(interpolationCurves & ~InterpolationCurve::Functional);
+        if((interpolationCurves & InterpolationCurve::Uniform) != 0)
+        {
+            output.write(setIndex, 2, interpolation.getUniformCurve());
+        }
+        if((interpolationCurves & InterpolationCurve::Distance) != 0)
+        {
+            output.write(setIndex, 3, interpolation.getDistanceCurve());
+        }
+        if((interpolationCurves & InterpolationCurve::RootDistance) != 0)
+        {
+            output.write(setIndex, 4, interpolation.getRootDistanceCurve());
+        }
+        if((interpolationCurves & InterpolationCurve::Chebycheff) != 0)
+        {
+            output.write(setIndex, 5, interpolation.getChebycheffCurve());
+        }
+    }
+    return setIndex;
+}
+
+/**
+ * Evaluates the curves of the point sets of a file, one set at a time.
+ * @return the number of point sets
+ */
+std::size_t processFile(const Options& options, const std::string& input)
+{
+    const bool isBinary = std::filesystem::path(input).extension() == pointSetExtension;
+    Output output(outputPath(options, input), options.binary);
+    try
+    {
+        std::size_t nbSets{0};
+        if(isBinary)
+        {
+            BinarySource source(input);
+            nbSets = processPointSets(options, source, output);
+        }
+        else
+        {
+            TextSource source(input);
+            nbSets = processPointSets(options, source, output);
+        }
+        output.finish();
+        return nbSets;
+    }
+    catch(const std::exception&)
+    {
+        // no partial results
+        output.discard();
+        throw;
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    std::optional<Options> options;
+    try
+    {
+        options = parseArguments(argc, argv);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if(!options.has_value())
+    {
+        return EXIT_SUCCESS;
+    }
+
+    std::mutex mutex;
+    bool failed{false};
+    // one file per task, the files being processed by the thread pool of the library
+    parallelFor(options->inputs.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i)
+        {
+            const auto& input = options->inputs[i];
+            try
+            {
+                const auto nbSets = processFile(options.value(), input);
+                const std::lock_guard<std::mutex> lock(mutex);
+                std::cout << input << ": " << nbSets << " point sets" << std::endl;
+            }
+            catch(const std::exception& e)
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                std::cerr << input << ": " << e.what() << std::endl;
+                failed = true;
+            }
+        }
+    });
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
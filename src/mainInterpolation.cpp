@@ -1,6 +1,10 @@
+#include "AllocationCounter.h"
 #include "Camera.h"
+#include <curves/AsyncCurve.h>
 #include <curves/ControlPoints.h>
 #include <curves/InterpolationCurve.h>
+#include <curves/ThreadPool.h>
+#include <curves/Tracer.h>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -20,14 +24,36 @@
 #include <GL/freeglut.h>
 #endif
 
+#include <atomic>
 #include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
 
 using namespace std;
 /*
  * Utils
  */
 Camera* camera;
-std::unique_ptr<InterpolationCurve> inter;
+/// the curves displayed by the render thread
+struct Curves
+{
+    std::vector<Point> functional{};
+    std::vector<Point> uniform{};
+    std::vector<Point> distance{};
+    std::vector<Point> rootDistance{};
+    std::vector<Point> chebycheff{};
+};
+/// the curves, computed on a background thread while the input is handled
+std::unique_ptr<AsyncCurve<InterpolationCurve, Curves>> inter;
+/// the control points edited by the input, in sync with the ones of the curves, to pick and draw them at once
+ControlPoints controlPoints;
+/// the parameters of the curves
+InterpolationCurve::Parameters parameters{};
+/// the version of the curves last displayed
+std::uint64_t drawnVersion{0};
+/// the delay between two checks of a new version of the curves, in milliseconds
+unsigned pollingDelay{10};
 bool track{false};
 std::size_t draggedPointIdx;
 /*
@@ -51,6 +77,12 @@ GLclampf backColor[3] = {.85f, .85f, .85f};
 double clickThresh{50.0};
 /// segments per Bezier curve
 std::size_t steps{100};
+/// file where the trace of the curves library is saved
+const char* traceFilename{"curvetool_trace.json"};
+/// number of nodes closest to each sample used by the windowed evaluation of the parametric curves
+std::size_t windowSize{8};
+/// maximum distance in pixels between the curves and their adaptive sampling
+double samplingTolerance{.25};
 
 bool draw_functional{false};
 bool draw_uniform{false};
@@ -58,6 +90,8 @@ bool draw_polygon{false};
 bool draw_distance{false};
 bool draw_root_distance{false};
 bool draw_chebycheff{false};
+/// the flags of the curves that are displayed, read by the background thread
+std::atomic<unsigned> visibleFlags{0};
 
 void drawCurve(const std::vector<Point>& points, const glm::dvec3& color)
 {
@@ -70,46 +104,132 @@ void drawCurve(const std::vector<Point>& points, const glm::dvec3& color)
     glLineWidth(1);
 }
 
+/**
+ * @return the flags of the curves that are displayed
+ */
+unsigned visibleCurves()
+{
+    unsigned curves{0};
+    curves |= draw_functional ? InterpolationCurve::Functional : 0U;
+    curves |= draw_uniform ? InterpolationCurve::Uniform : 0U;
+    curves |= draw_distance ? InterpolationCurve::Distance : 0U;
+    curves |= draw_root_distance ? InterpolationCurve::RootDistance : 0U;
+    curves |= draw_chebycheff ? InterpolationCurve::Chebycheff : 0U;
+    return curves;
+}
+
+/**
+ * Computes the displayed curves, on the background thread
+ * @param curve The curve
+ * @param curves The curves to display, their memory is reused
+ */
+void buildCurves(const InterpolationCurve& curve, Curves& curves)
+{
+    const auto flags = visibleFlags.load();
+    // computing the displayed curves at once, the hidden ones are not computed
+    curve.update(flags);
+    using Get = const std::vector<Point>& (InterpolationCurve::*)() const;
+    const auto copy = [flags, &curve](unsigned flag, Get get, std::vector<Point>& out) {
+        if((flags & flag) != 0)
+        {
+            const auto& points = (curve.*get)();
+            out.assign(points.begin(), points.end());
+        }
+        else
+        {
+            out.clear();
+        }
+    };
+    copy(InterpolationCurve::Functional, &InterpolationCurve::getFunctionalCurve, curves.functional);
+    copy(InterpolationCurve::Uniform, &InterpolationCurve::getUniformCurve, curves.uniform);
+    copy(InterpolationCurve::Distance, &InterpolationCurve::getDistanceCurve, curves.distance);
+    copy(InterpolationCurve::RootDistance, &InterpolationCurve::getRootDistanceCurve, curves.rootDistance);
+    copy(InterpolationCurve::Chebycheff, &InterpolationCurve::getChebycheffCurve, curves.chebycheff);
+}
+
+/**
+ * Redisplays the curves when the background thread has computed a new version
+ */
+void poll(int)
+{
+    if(inter->version() != drawnVersion)
+    {
+        glutPostRedisplay();
+    }
+    glutTimerFunc(pollingDelay, poll, 0);
+}
+
+/**
+ * @return the last computed curves, the errors of the background thread being reported on the standard error
+ */
+std::shared_ptr<const Curves> latestSnapshot()
+{
+    try
+    {
+        return inter->snapshot();
+    }
+    catch(const std::exception& e)
+    {
+        // the worker has dropped the rest of the failed batch, its curve is set again from the points shown here so
+        // that the indices of the next edits designate the same points, the previous curves being drawn meanwhile
+        std::cerr << "Error while computing the curves: " << e.what() << std::endl;
+        inter->edit([points = controlPoints.getControlPoints(), p = parameters](InterpolationCurve& curve) {
+            curve.setParameters(p);
+            curve.setControlPoints(points);
+        });
+        return inter->snapshot();
+    }
+}
+
+/**
+ * Stops the background thread, called by exit() whether the user quits or closes the window.
+ */
+void stopWorker() { inter.reset(); }
+
 /**
  * The rendering function
  */
 void draw()
 {
+    CURVES_TRACE_SCOPE("draw");
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // the last computed curves, possibly a few events behind the control points
+    drawnVersion = inter->version();
+    const auto curves = latestSnapshot();
     // drawing the bounding box
     if(draw_polygon)
     {
-        drawCurve(inter->getControlPoints(), controlColor);
+        drawCurve(controlPoints.getControlPoints(), controlColor);
     }
 
     if(draw_functional)
     {
         // drawing the functional curve
-        drawCurve(inter->getFunctionalCurve(), functionalColor);
+        drawCurve(curves->functional, functionalColor);
     }
 
     if(draw_uniform)
     {
         // drawing the uniform curve
-        drawCurve(inter->getUniformCurve(), uniformColor);
+        drawCurve(curves->uniform, uniformColor);
     }
 
     if(draw_distance)
     {
         // drawing the distance curve
-        drawCurve(inter->getDistanceCurve(), distanceColor);
+        drawCurve(curves->distance, distanceColor);
     }
 
     if(draw_root_distance)
     {
         // drawing the root distance curve
-        drawCurve(inter->getRootDistanceCurve(), rootDistanceColor);
+        drawCurve(curves->rootDistance, rootDistanceColor);
     }
 
     if(draw_chebycheff)
     {
         // drawing the root distance curve
-        drawCurve(inter->getChebycheffCurve(), chebycheffColor);
+        drawCurve(curves->chebycheff, chebycheffColor);
     }
 
 
@@ -117,7 +237,7 @@ void draw()
     glPointSize(8.f);
     glBegin(GL_POINTS);
     glColor3d(controlColor[0], controlColor[1], controlColor[2]);
-    for(const auto& point : inter->getControlPoints())
+    for(const auto& point : controlPoints.getControlPoints())
         glVertex2d(point.x, point.y);
     glEnd();
     glPointSize(1.f);
@@ -137,15 +257,23 @@ void mouseClick(int button, int state, int x, int y)
     Point n{(double)x, window_height - (double)y};
     if(button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) // addition
     {
-        inter->add(n);
+        controlPoints.add(n);
+        inter->edit([n](InterpolationCurve& curve) { curve.add(n); });
     }
     else if(button == GLUT_MIDDLE_BUTTON && state == GLUT_DOWN)
     {
-        inter->deleteControlPoint(n, clickThresh);
+        // the point is picked once, both sets of points being the same its index is the same in the curve
+        const auto res = controlPoints.getIndexClosestPoint(n, clickThresh);
+        if(res.has_value())
+        {
+            const auto idx = res.value();
+            controlPoints.deleteControlPointAtIndex(idx);
+            inter->edit([idx](InterpolationCurve& curve) { curve.deleteControlPointAtIndex(idx); });
+        }
     }
     else if(button == GLUT_RIGHT_BUTTON && state == GLUT_DOWN) // start tracking mouse for dragging
     {
-        const auto res = inter->getIndexClosestPoint(n, clickThresh);
+        const auto res = controlPoints.getIndexClosestPoint(n, clickThresh);
         if(res.has_value())
         {
             track = true;
@@ -166,13 +294,41 @@ void mouseClick(int button, int state, int x, int y)
  */
 void mouseMove(int x, int y)
 {
+    CURVES_TRACE_SCOPE("mouseMove");
     if(!track)
         return;
     Point p = {(double)x, window_height - (double)y};
-    inter->updateControlPointAtIndex(draggedPointIdx, p, clickThresh);
+    // the control points follow the mouse at once, the curves once the background thread has computed them
+    controlPoints.updateControlPointAtIndex(draggedPointIdx, p, clickThresh);
+    inter->move(draggedPointIdx, p);
     glutPostRedisplay();
 }
 
+/**
+ * Starts recording the hot paths of the curves library, or stops recording and saves the trace
+ */
+void toggleTracing()
+{
+    auto& tracer = Tracer::instance();
+    if(!Tracer::isAvailable())
+    {
+        std::cout << "Tracing is not available, configure with -DCURVES_ENABLE_TRACING=ON" << std::endl;
+        return;
+    }
+    if(!tracer.isEnabled())
+    {
+        tracer.clear();
+        tracer.setEnabled(true);
+        std::cout << "Tracing started" << std::endl;
+        return;
+    }
+    tracer.setEnabled(false);
+    if(tracer.write(traceFilename))
+    {
+        std::cout << "Trace saved in " << traceFilename << std::endl;
+    }
+}
+
 /**
  * Handles key presses
  * @param key the keyboard input given by the user
@@ -184,7 +340,8 @@ void keyPress(unsigned char key, int, int)
     switch(key)
     {
         case 'c':
-            inter->reset();
+            controlPoints.reset();
+            inter->edit([](InterpolationCurve& curve) { curve.reset(); });
             break;
         case 'f':
             draw_functional = !draw_functional;
@@ -204,11 +361,30 @@ void keyPress(unsigned char key, int, int)
         case 't':
             draw_chebycheff = !draw_chebycheff;
             break;
+        case 'w':
+            parameters.window = parameters.window == 0 ? windowSize : 0;
+            inter->edit([p = parameters](InterpolationCurve& curve) { curve.setParameters(p); });
+            break;
+        case 'a':
+            parameters.sampling = parameters.sampling == InterpolationCurve::Sampling::Step
+                                      ? InterpolationCurve::Sampling::Adaptive
+                                      : InterpolationCurve::Sampling::Step;
+            inter->edit([p = parameters](InterpolationCurve& curve) { curve.setParameters(p); });
+            break;
+        case 'x':
+            toggleTracing();
+            break;
         case 'q':
             exit(EXIT_SUCCESS);
         default:
             break;
     }
+    // the curves that have just been displayed are computed
+    const auto flags = visibleCurves();
+    if(visibleFlags.exchange(flags) != flags)
+    {
+        inter->rebuild();
+    }
     glutPostRedisplay();
 }
 
@@ -229,17 +405,30 @@ void initGlut()
     glutInitWindowSize(window_width, window_height);
     glutCreateWindow("Interpolation");
     camera = new Camera(window_width, window_height);
-    InterpolationCurve::Parameters param{0, static_cast<double>(window_width), 0.05};
-    inter = std::make_unique<InterpolationCurve>(param);
+    parameters = InterpolationCurve::Parameters{0, static_cast<double>(window_width), 0.05};
+    parameters.sampling = InterpolationCurve::Sampling::Adaptive;
+    parameters.tolerance = samplingTolerance;
+    parameters.viewport = {0, 0, static_cast<double>(window_width), static_cast<double>(window_height)};
+    inter = std::make_unique<AsyncCurve<InterpolationCurve, Curves>>(std::make_unique<InterpolationCurve>(parameters),
+                                                                      &buildCurves);
+    // the worker may be using the thread pool of the library, which is destroyed with the other statics by exit(): the
+    // pool is created before registering the handler stopping the worker so that it is destroyed after it
+    ThreadPool::instance();
+    std::atexit(stopWorker);
     glClearColor(backColor[0], backColor[1], backColor[2], 0);
     glutMouseFunc(mouseClick);
     glutMotionFunc(mouseMove);
     glutKeyboardFunc(keyPress);
     glutReshapeFunc( reshape );
+    glutTimerFunc(pollingDelay, poll, 0);
 }
 
 int main(int, char**)
 {
+#ifdef CURVES_ENABLE_TRACING
+    // the allocations of the traced scopes are counted by the allocation functions of AllocationCounter.cpp
+    Tracer::setAllocationCounter(threadAllocationCount);
+#endif
     initGlut();
     glutDisplayFunc(draw);
     glutMainLoop();
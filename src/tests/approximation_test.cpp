@@ -0,0 +1,270 @@
+#include <AllocationCounter.h>
+#include <curves/approximation.h>
+#include <curves/BernsteinBasis.h>
+#include <curves/BezierCurve.h>
+#include <curves/parametrization.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+std::vector<Point> makeControlPoints(std::size_t nbPoints)
+{
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        points.emplace_back(x, x * x * .1 - 3. * x);
+    }
+    return points;
+}
+
+/// a Bezier curve counting the full computations of its curve
+class CountingBezierCurve : public BezierCurve
+{
+public:
+    using BezierCurve::BezierCurve;
+
+    std::size_t rebuilds{0};
+
+protected:
+    void rebuild() override
+    {
+        ++rebuilds;
+        BezierCurve::rebuild();
+    }
+};
+}
+
+TEST(DeCasteljauTest, BatchAgreesWithSingle)
+{
+    const auto t = uniformParametrization(100);
+    for(const std::size_t nbPoints : {1u, 2u, 5u, 32u, 33u, 60u})
+    {
+        const auto points = makeControlPoints(nbPoints);
+        std::vector<Point> out(t.size());
+        deCasteljau(points, t, out);
+        for(std::size_t i{0}; i < t.size(); ++i)
+        {
+            EXPECT_NEAR(glm::distance(out[i], deCasteljau(points, 0, nbPoints - 1, t[i])), 0, 1e-9);
+        }
+        EXPECT_NEAR(glm::distance(out.front(), points.front()), 0, 1e-9);
+        EXPECT_NEAR(glm::distance(out.back(), points.back()), 0, 1e-9);
+    }
+}
+
+TEST(DeCasteljauTest, NoAllocationPerSample)
+{
+    const auto t = uniformParametrization(20000);
+    std::vector<Point> out(t.size());
+    std::vector<Point> workspace{};
+    for(const std::size_t nbPoints : {4u, 32u, 50u})
+    {
+        const auto points = makeControlPoints(nbPoints);
+        // the first evaluation may size the workspace, the next ones must not allocate at all
+        deCasteljau(points, t, out, workspace);
+        const auto before = allocationCount();
+        deCasteljau(points, t, out, workspace);
+        EXPECT_EQ(allocationCount(), before);
+        // without workspace there is at most one allocation for all the samples
+        const auto beforeTemp = allocationCount();
+        deCasteljau(points, t, out);
+        EXPECT_LE(allocationCount() - beforeTemp, 1u);
+    }
+}
+
+TEST(BernsteinBasisTest, PartitionOfUnity)
+{
+    const BernsteinBasis basis(7, 50);
+    for(std::size_t s{0}; s <= 50; ++s)
+    {
+        double sum{0};
+        for(std::size_t i{0}; i <= 7; ++i)
+        {
+            EXPECT_GE(basis(s, i), 0.);
+            sum += basis(s, i);
+        }
+        EXPECT_NEAR(sum, 1., 1e-12);
+    }
+}
+
+TEST(BernsteinBasisTest, AgreesWithDeCasteljau)
+{
+    const std::size_t steps{37};
+    const auto t = uniformParametrization(steps);
+    for(const std::size_t nbPoints : {1u, 2u, 5u, 8u, 33u})
+    {
+        const auto points = makeControlPoints(nbPoints);
+        const auto basis = BernsteinBasis::get(nbPoints - 1, steps);
+        std::vector<double> X(basis->paddedSize(), 0.);
+        std::vector<double> Y(basis->paddedSize(), 0.);
+        for(std::size_t i{0}; i < nbPoints; ++i)
+        {
+            X[i] = points[i].x;
+            Y[i] = points[i].y;
+        }
+        std::vector<Point> out(t.size());
+        basis->evaluate(X, Y, out);
+        std::vector<Point> expected(t.size());
+        deCasteljau(points, t, expected);
+        for(std::size_t i{0}; i < t.size(); ++i)
+        {
+            EXPECT_NEAR(glm::distance(out[i], expected[i]), 0, 1e-9);
+        }
+    }
+}
+
+TEST(BernsteinBasisTest, SharedMatrices)
+{
+    const auto basis = BernsteinBasis::get(5, 100);
+    EXPECT_EQ(BernsteinBasis::get(5, 100), basis);
+    EXPECT_NE(BernsteinBasis::get(6, 100), basis);
+    EXPECT_NE(BernsteinBasis::get(5, 99), basis);
+    EXPECT_EQ(basis->getDegree(), 5u);
+    EXPECT_EQ(basis->getSteps(), 100u);
+}
+
+TEST(BezierCurveTest, IncrementalEditsAgreeWithRebuild)
+{
+    auto points = makeControlPoints(12);
+    BezierCurve curve(200);
+    for(const auto& p : points)
+    {
+        curve.add(p);
+    }
+    // more moves than the number of displacements applied before rebuilding the curve
+    for(std::size_t k{0}; k < 150; ++k)
+    {
+        const auto idx = (k * 7) % points.size();
+        points[idx] += Point{std::sin(static_cast<double>(k)), std::cos(static_cast<double>(k))};
+        curve.updateControlPointAtIndex(idx, points[idx], 1.);
+    }
+    BezierCurve expected(200);
+    expected.makeFromVector(points);
+    ASSERT_EQ(curve.getCurvePoint().size(), 201u);
+    ASSERT_EQ(expected.getCurvePoint().size(), 201u);
+    for(std::size_t i{0}; i < curve.getCurvePoint().size(); ++i)
+    {
+        EXPECT_NEAR(glm::distance(curve.getCurvePoint()[i], expected.getCurvePoint()[i]), 0, 1e-9);
+    }
+}
+
+TEST(BezierCurveTest, TransactionComputesTheCurveOnce)
+{
+    auto points = makeControlPoints(12);
+    CountingBezierCurve curve(200);
+    {
+        ControlPoints::Transaction transaction(curve);
+        for(const auto& p : points)
+        {
+            curve.add(p);
+        }
+        {
+            // the nested batch is committed with the outer one
+            ControlPoints::Transaction nested(curve);
+            points[3] += Point{1., -2.};
+            curve.updateControlPointAtIndex(3, points[3], 1.);
+            nested.commit();
+        }
+        EXPECT_TRUE(curve.deleteControlPoint(points[7], 1e-3));
+        points.erase(points.begin() + 7);
+        EXPECT_TRUE(curve.inTransaction());
+        EXPECT_EQ(curve.rebuilds, 0u);
+        transaction.commit();
+    }
+    EXPECT_FALSE(curve.inTransaction());
+    EXPECT_EQ(curve.rebuilds, 1u);
+    BezierCurve expected(200);
+    expected.makeFromVector(points);
+    ASSERT_EQ(curve.getCurvePoint().size(), 201u);
+    for(std::size_t i{0}; i < curve.getCurvePoint().size(); ++i)
+    {
+        EXPECT_NEAR(glm::distance(curve.getCurvePoint()[i], expected.getCurvePoint()[i]), 0, 1e-9);
+    }
+    // a batch without edits leaves the curve as it is
+    curve.beginEdit();
+    curve.commitEdit();
+    EXPECT_EQ(curve.rebuilds, 1u);
+    curve.setControlPoints(makeControlPoints(5));
+    EXPECT_EQ(curve.rebuilds, 2u);
+}
+
+TEST(BezierCurveTest, TransactionAbandonedByAnException)
+{
+    auto points = makeControlPoints(6);
+    CountingBezierCurve curve(100);
+    curve.makeFromVector(points);
+    const auto failingBatch = [&] {
+        ControlPoints::Transaction transaction(curve);
+        points[2] += Point{3., 1.};
+        curve.updateControlPointAtIndex(2, points[2], 1.);
+        throw std::runtime_error("edit");
+    };
+    EXPECT_THROW(failingBatch(), std::runtime_error);
+    // the batch is ended without computing the curve, which is computed with the next edit
+    EXPECT_FALSE(curve.inTransaction());
+    EXPECT_EQ(curve.rebuilds, 1u);
+    points[4] += Point{-1., 2.};
+    curve.updateControlPointAtIndex(4, points[4], 1.);
+    EXPECT_EQ(curve.rebuilds, 2u);
+    BezierCurve expected(100);
+    expected.makeFromVector(points);
+    ASSERT_EQ(curve.getCurvePoint().size(), expected.getCurvePoint().size());
+    for(std::size_t i{0}; i < curve.getCurvePoint().size(); ++i)
+    {
+        EXPECT_NEAR(glm::distance(curve.getCurvePoint()[i], expected.getCurvePoint()[i]), 0, 1e-9);
+    }
+}
+
+TEST(AdaptiveTessellationTest, StaysWithinTolerance)
+{
+    const auto points = makeControlPoints(8);
+    const auto t = uniformParametrization(2000);
+    std::vector<Point> dense(t.size());
+    deCasteljau(points, t, dense);
+    std::vector<Point> out{};
+    std::vector<Point> workspace{};
+    for(const double tolerance : {1., .25, .01})
+    {
+        adaptiveTessellation(points, tolerance, out, workspace);
+        ASSERT_GE(out.size(), 2u);
+        EXPECT_NEAR(glm::distance(out.front(), points.front()), 0, 1e-9);
+        EXPECT_NEAR(glm::distance(out.back(), points.back()), 0, 1e-9);
+        // each point of the curve is close to a segment of the polyline
+        for(const auto& p : dense)
+        {
+            auto closest = std::numeric_limits<double>::max();
+            for(std::size_t i{0}; i + 1 < out.size(); ++i)
+            {
+                const auto chord = out[i + 1] - out[i];
+                const auto u = std::clamp(glm::dot(p - out[i], chord) / glm::dot(chord, chord), 0., 1.);
+                closest = std::min(closest, glm::distance(p, out[i] + u * chord));
+            }
+            EXPECT_LE(closest, tolerance + 1e-9);
+        }
+    }
+}
+
+TEST(AdaptiveTessellationTest, FlatCurvesNeedFewVertices)
+{
+    const std::vector<Point> line{{0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4}};
+    std::vector<Point> out{};
+    std::vector<Point> workspace{};
+    adaptiveTessellation(line, .1, out, workspace);
+    EXPECT_EQ(out.size(), 2u);
+
+    BezierCurve curve(1000);
+    curve.setTessellation(BezierCurve::Tessellation::Adaptive, .25);
+    for(const auto& p : makeControlPoints(6))
+    {
+        curve.add(p);
+    }
+    EXPECT_LT(curve.getCurvePoint().size(), 1001u);
+    curve.setTessellation(BezierCurve::Tessellation::Uniform);
+    EXPECT_EQ(curve.getCurvePoint().size(), 1001u);
+}
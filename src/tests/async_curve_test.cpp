@@ -0,0 +1,198 @@
+#include <curves/AsyncCurve.h>
+#include <curves/ControlPoints.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+/// control points counting their moves, whose snapshot can be held back by the test
+class BlockingCurve : public ControlPoints
+{
+public:
+    void updateControlPointAtIndex(std::size_t idx, const Point& p_new, double threshold) override
+    {
+        ControlPoints::updateControlPointAtIndex(idx, p_new, threshold);
+        ++moves;
+    }
+
+    std::size_t moves{0};
+};
+
+/// lets the builds of the snapshots proceed one by one
+class Gate
+{
+public:
+    void open()
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        opened = true;
+        condition.notify_all();
+    }
+
+    void pass()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered = true;
+        condition.notify_all();
+        condition.wait(lock, [this] { return opened; });
+    }
+
+    void waitEntered()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return entered; });
+    }
+
+private:
+    std::mutex mutex{};
+    std::condition_variable condition{};
+    bool opened{false};
+    bool entered{false};
+};
+
+/// the snapshot of the points and of the number of moves applied to them
+struct Snapshot
+{
+    std::vector<Point> points{};
+    std::size_t moves{0};
+};
+
+void copyPoints(const BlockingCurve& curve, Snapshot& snapshot)
+{
+    const auto& points = curve.getControlPoints();
+    snapshot.points.assign(points.begin(), points.end());
+    snapshot.moves = curve.moves;
+}
+}
+
+TEST(AsyncCurveTest, AppliesTheEditsInOrder)
+{
+    AsyncCurve<BlockingCurve, Snapshot> curve(std::make_unique<BlockingCurve>(), &copyPoints);
+    curve.edit([](BlockingCurve& c) { c.add({1, 1}); });
+    curve.edit([](BlockingCurve& c) { c.add({2, 2}); });
+    curve.move(0, {3, 3});
+    curve.edit([](BlockingCurve& c) { c.add({4, 4}); });
+    curve.wait();
+    const auto snapshot = curve.snapshot();
+    EXPECT_EQ(snapshot->points, (std::vector<Point>{{3, 3}, {2, 2}, {4, 4}}));
+    EXPECT_GE(curve.version(), 1u);
+}
+
+TEST(AsyncCurveTest, MergesTheMovesOfAPoint)
+{
+    Gate gate;
+    bool first{true};
+    AsyncCurve<BlockingCurve, Snapshot> curve(std::make_unique<BlockingCurve>(),
+                                              [&](const BlockingCurve& c, Snapshot& snapshot) {
+                                                  // the first build waits while the moves are queued
+                                                  if(first)
+                                                  {
+                                                      first = false;
+                                                      gate.pass();
+                                                  }
+                                                  copyPoints(c, snapshot);
+                                              });
+    gate.waitEntered();
+    curve.edit([](BlockingCurve& c) {
+        c.add({0, 0});
+        c.add({10, 10});
+    });
+    for(int i{0}; i < 100; ++i)
+    {
+        curve.move(1, {static_cast<double>(i), 1.});
+    }
+    curve.move(0, {5, 5});
+    curve.move(0, {6, 6});
+    gate.open();
+    curve.wait();
+    const auto snapshot = curve.snapshot();
+    EXPECT_EQ(snapshot->points, (std::vector<Point>{{6, 6}, {99, 1}}));
+    // one move per point
+    EXPECT_EQ(snapshot->moves, 2u);
+}
+
+TEST(AsyncCurveTest, DoesNotWaitForTheBuild)
+{
+    Gate gate;
+    AsyncCurve<BlockingCurve, Snapshot> curve(std::make_unique<BlockingCurve>(),
+                                              [&](const BlockingCurve& c, Snapshot& snapshot) {
+                                                  gate.pass();
+                                                  copyPoints(c, snapshot);
+                                              });
+    gate.waitEntered();
+    // while the worker is busy the edits are queued and the previous snapshot is read without waiting
+    const auto start = std::chrono::steady_clock::now();
+    curve.edit([](BlockingCurve& c) { c.add({1, 1}); });
+    for(int i{0}; i < 1000; ++i)
+    {
+        curve.move(0, {static_cast<double>(i), 0});
+        EXPECT_TRUE(curve.snapshot()->points.empty());
+    }
+    EXPECT_EQ(curve.version(), 0u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    gate.open();
+    curve.wait();
+    EXPECT_EQ(curve.snapshot()->points, (std::vector<Point>{{999, 0}}));
+}
+
+TEST(AsyncCurveTest, KeepsTheHeldSnapshot)
+{
+    AsyncCurve<BlockingCurve, Snapshot> curve(std::make_unique<BlockingCurve>(), &copyPoints);
+    curve.edit([](BlockingCurve& c) { c.add({1, 1}); });
+    curve.wait();
+    const auto held = curve.snapshot();
+    for(int i{0}; i < 10; ++i)
+    {
+        curve.move(0, {static_cast<double>(i), 0});
+        curve.wait();
+    }
+    EXPECT_EQ(held->points, (std::vector<Point>{{1, 1}}));
+    EXPECT_EQ(curve.snapshot()->points, (std::vector<Point>{{9, 0}}));
+}
+
+TEST(AsyncCurveTest, RethrowsTheErrorsOfTheWorker)
+{
+    AsyncCurve<BlockingCurve, Snapshot> curve(std::make_unique<BlockingCurve>(), &copyPoints);
+    curve.edit([](BlockingCurve& c) { c.add({1, 1}); });
+    curve.wait();
+    const auto version = curve.version();
+    curve.edit([](BlockingCurve&) { throw std::runtime_error("edit"); });
+    curve.wait();
+    // the failed batch is counted so that the render thread reads its error
+    EXPECT_GT(curve.version(), version);
+    EXPECT_THROW(static_cast<void>(curve.snapshot()), std::runtime_error);
+    // the previous snapshot is kept, and the worker goes on with the next edits
+    EXPECT_EQ(curve.snapshot()->points, (std::vector<Point>{{1, 1}}));
+    curve.edit([](BlockingCurve& c) { c.add({2, 2}); });
+    curve.wait();
+    EXPECT_EQ(curve.snapshot()->points, (std::vector<Point>{{1, 1}, {2, 2}}));
+}
+
+TEST(AsyncCurveTest, ResynchronizedAfterAnError)
+{
+    Gate gate;
+    AsyncCurve<BlockingCurve, Snapshot> curve(std::make_unique<BlockingCurve>(),
+                                              [&](const BlockingCurve& c, Snapshot& snapshot) {
+                                                  gate.pass();
+                                                  copyPoints(c, snapshot);
+                                              });
+    // the copy of the points kept by the caller, all its edits being applied to it
+    const std::vector<Point> points{{1, 1}, {2, 2}, {3, 3}};
+    gate.waitEntered();
+    // queued as a single batch while the first snapshot is built, the edit after the failing one is dropped
+    curve.edit([](BlockingCurve& c) { c.add({1, 1}); });
+    curve.edit([](BlockingCurve& c) { c.add({2, 2}); });
+    curve.edit([](BlockingCurve&) { throw std::runtime_error("edit"); });
+    curve.edit([](BlockingCurve& c) { c.add({3, 3}); });
+    gate.open();
+    curve.wait();
+    EXPECT_THROW(static_cast<void>(curve.snapshot()), std::runtime_error);
+    curve.edit([points](BlockingCurve& c) { c.setControlPoints(points); });
+    curve.wait();
+    EXPECT_EQ(curve.snapshot()->points, points);
+}
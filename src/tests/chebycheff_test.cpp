@@ -0,0 +1,115 @@
+#include <curves/ChebycheffSeries.h>
+#include <curves/interpolation.h>
+#include <curves/InterpolationCurve.h>
+#include <curves/parametrization.h>
+
+#include <gtest/gtest.h>
+
+#include <glm/ext/scalar_constants.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+std::vector<Point> makeWave(std::size_t nbPoints)
+{
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        points.emplace_back(10. * x + 3. * std::cos(x), 50. * std::sin(x * .3));
+    }
+    return points;
+}
+
+/// the lengths of the transforms, powers of two and lengths computed with Bluestein's algorithm
+const std::vector<std::size_t> sizes{1, 2, 3, 4, 5, 7, 8, 12, 13, 16, 17, 31, 64, 100};
+}
+
+TEST(ChebycheffSeriesTest, CoefficientsAreTheCosineTransform)
+{
+    for(const auto n : sizes)
+    {
+        const auto points = makeWave(n);
+        const auto [X, Y] = splitCoordinates(points);
+        ChebycheffSeries series;
+        series.build(X, Y);
+        ASSERT_EQ(series.size(), n);
+        for(std::size_t k{0}; k < n; ++k)
+        {
+            Point expected{0, 0};
+            for(std::size_t i{0}; i < n; ++i)
+            {
+                const auto angle = static_cast<double>(k * (2 * i + 1)) / static_cast<double>(2 * n);
+                expected += points[i] * std::cos(glm::pi<double>() * angle);
+            }
+            expected *= (k == 0 ? 1. : 2.) / static_cast<double>(n);
+            EXPECT_NEAR(glm::distance(series.getCoefficients()[k], expected), 0, 1e-9) << "n " << n << " k " << k;
+        }
+    }
+}
+
+TEST(ChebycheffSeriesTest, AgreesWithBarycentric)
+{
+    for(const auto n : sizes)
+    {
+        const auto points = makeWave(n);
+        const auto [X, Y] = splitCoordinates(points);
+        const auto T = computeChebycheffSubdivision(points);
+        ChebycheffSeries series;
+        series.build(X, Y);
+        // the curve passes through the points
+        for(std::size_t i{0}; i < n; ++i)
+        {
+            EXPECT_NEAR(glm::distance(series(T[i]), points[i]), 0, 1e-9) << "n " << n << " i " << i;
+        }
+        if(n < 2)
+        {
+            continue;
+        }
+        const auto tToEval = createSamples(.01, T);
+        const auto expected = applyBarycentricSubdivision(X, Y, T, barycentricWeights(T), tToEval);
+        const auto res = applyChebycheffSubdivision(series.getCoefficients(), tToEval);
+        ASSERT_EQ(res.size(), tToEval.size());
+        for(std::size_t i{0}; i < res.size(); ++i)
+        {
+            EXPECT_NEAR(glm::distance(res[i], expected[i]), 0, 1e-7) << "n " << n << " t " << tToEval[i];
+            EXPECT_NEAR(glm::distance(res[i], series(tToEval[i])), 0, 1e-9);
+        }
+    }
+}
+
+TEST(ChebycheffSeriesTest, RebuildWithAnotherSize)
+{
+    ChebycheffSeries series;
+    for(const auto n : {std::size_t{12}, std::size_t{16}, std::size_t{12}, std::size_t{5}})
+    {
+        const auto points = makeWave(n);
+        const auto [X, Y] = splitCoordinates(points);
+        series.build(X, Y);
+        const auto T = computeChebycheffSubdivision(points);
+        for(std::size_t i{0}; i < n; ++i)
+        {
+            EXPECT_NEAR(glm::distance(series(T[i]), points[i]), 0, 1e-9);
+        }
+    }
+}
+
+TEST(InterpolationCurveTest, ChebycheffCurveFollowsTheStep)
+{
+    const auto points = makeWave(11);
+    for(const double step : {.1, .01})
+    {
+        InterpolationCurve curve(InterpolationCurve::Parameters(0, 100, step));
+        for(const auto& p : points)
+        {
+            curve.add(p);
+        }
+        const auto& res = curve.getChebycheffCurve();
+        // as many samples per interval between two nodes as the uniform curve
+        EXPECT_NEAR(static_cast<double>(res.size()), static_cast<double>(curve.getUniformCurve().size()), 2.);
+        // the curve goes from the last point to the first one
+        EXPECT_NEAR(glm::distance(res.front(), points.back()), 0, 1e-9);
+        EXPECT_NEAR(glm::distance(res.back(), points.front()), 0, 1e-9);
+    }
+}
@@ -0,0 +1,137 @@
+#include <curves/ControlPoints.h>
+#include <curves/CoordinateArrays.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+void expectInSync(const ControlPoints& controlPoints)
+{
+    const auto& points = controlPoints.getControlPoints();
+    const auto& arrays = controlPoints.getCoordinateArrays();
+    ASSERT_EQ(arrays.size(), points.size());
+    for(std::size_t i{0}; i < points.size(); ++i)
+    {
+        EXPECT_EQ(arrays.xs()[i], points[i].x);
+        EXPECT_EQ(arrays.ys()[i], points[i].y);
+    }
+}
+
+bool isAligned(const double* ptr) { return reinterpret_cast<std::uintptr_t>(ptr) % CoordinateArrays::alignment == 0; }
+}
+
+TEST(CoordinateArraysTest, AlignedArrays)
+{
+    CoordinateArrays arrays;
+    for(std::size_t i{0}; i < 100; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        arrays.push_back({x, -x});
+        EXPECT_TRUE(isAligned(arrays.xs().data()));
+        EXPECT_TRUE(isAligned(arrays.ys().data()));
+    }
+    const auto copy = arrays;
+    ASSERT_EQ(copy.size(), arrays.size());
+    EXPECT_TRUE(isAligned(copy.xs().data()));
+    for(std::size_t i{0}; i < arrays.size(); ++i)
+    {
+        EXPECT_EQ(copy.xs()[i], static_cast<double>(i));
+        EXPECT_EQ(copy.ys()[i], -static_cast<double>(i));
+    }
+}
+
+TEST(CoordinateArraysTest, ReusesAMovedFromObject)
+{
+    CoordinateArrays arrays;
+    for(std::size_t i{0}; i < 10; ++i)
+    {
+        arrays.push_back({static_cast<double>(i), 1.});
+    }
+    CoordinateArrays moved(std::move(arrays));
+    EXPECT_EQ(moved.size(), 10u);
+    // the moved-from arrays are left empty
+    EXPECT_TRUE(arrays.empty());
+    // the moved-from arrays allocate again when they grow
+    for(std::size_t i{0}; i < 20; ++i)
+    {
+        arrays.push_back({2., static_cast<double>(i)});
+    }
+    ASSERT_EQ(arrays.size(), 20u);
+    EXPECT_TRUE(isAligned(arrays.xs().data()));
+    EXPECT_EQ(arrays.ys()[19], 19.);
+    moved = std::move(arrays);
+    EXPECT_EQ(moved.size(), 20u);
+    EXPECT_EQ(moved.xs()[0], 2.);
+    EXPECT_TRUE(arrays.empty());
+    arrays.push_back({3., 4.});
+    ASSERT_EQ(arrays.size(), 1u);
+    EXPECT_EQ(arrays.xs()[0], 3.);
+}
+
+TEST(CoordinateArraysTest, InSyncWithTheEdits)
+{
+    ControlPoints controlPoints;
+    controlPoints.add({0, 1});
+    controlPoints.add({10, 11});
+    // the arrays are only kept on demand
+    EXPECT_FALSE(controlPoints.hasCoordinateArrays());
+    EXPECT_TRUE(controlPoints.getCoordinateArrays().empty());
+    controlPoints.keepCoordinateArrays(true);
+    expectInSync(controlPoints);
+    for(std::size_t i{0}; i < 20; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        controlPoints.add({20. + 10. * x, x * x});
+    }
+    expectInSync(controlPoints);
+    controlPoints.updateControlPointAtIndex(5, {55, -5}, 1);
+    expectInSync(controlPoints);
+    EXPECT_TRUE(controlPoints.updateControlPoint({55, -5}, {56, -6}, 1));
+    expectInSync(controlPoints);
+    EXPECT_TRUE(controlPoints.deleteControlPoint({0, 1}, 1));
+    expectInSync(controlPoints);
+    EXPECT_TRUE(controlPoints.deleteControlPoint({56, -6}, 1));
+    expectInSync(controlPoints);
+    controlPoints.reset();
+    expectInSync(controlPoints);
+    controlPoints.add({3, 4});
+    expectInSync(controlPoints);
+    controlPoints.keepCoordinateArrays(false);
+    EXPECT_TRUE(controlPoints.getCoordinateArrays().empty());
+}
+
+TEST(CoordinateArraysTest, ClosestAgreesWithScan)
+{
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> coordinate(-100., 100.);
+    std::vector<Point> points{};
+    CoordinateArrays arrays;
+    // the sizes that are not a multiple of the registers end with points checked one by one
+    for(std::size_t i{0}; i < 203; ++i)
+    {
+        points.emplace_back(coordinate(generator), coordinate(generator));
+        arrays.push_back(points.back());
+        const Point p{coordinate(generator), coordinate(generator)};
+        for(const auto threshold : {-1., 0., 5., 30., 1e3})
+        {
+            EXPECT_EQ(arrays.closest(p, threshold), getClosestPointIndex(points, p, threshold));
+        }
+        EXPECT_EQ(arrays.closest(points[i / 2], 0.), getClosestPointIndex(points, points[i / 2], 0.));
+    }
+    // the ties go to the lowest index
+    const std::vector<Point> same(9, Point{1., 1.});
+    arrays.assign(same);
+    EXPECT_EQ(arrays.closest({1., 2.}, 1.), 0u);
+    // the control points scan their arrays when the radius spans more cells than points
+    ControlPoints controlPoints;
+    controlPoints.keepCoordinateArrays(true);
+    for(const auto& p : points)
+    {
+        controlPoints.add(p);
+    }
+    EXPECT_EQ(controlPoints.getIndexClosestPoint({0., 0.}, 1e4), getClosestPointIndex(points, {0., 0.}, 1e4));
+}
@@ -1,7 +1,16 @@
+#include <AllocationCounter.h>
 #include <curves/interpolation.h>
+#include <curves/InterpolationCurve.h>
+#include <curves/NewtonPolynomial.h>
+#include <curves/parametrization.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 TEST(LagrangeTest, LagrangeValues)
@@ -16,3 +25,420 @@ TEST(LagrangeTest, LagrangeValues)
         EXPECT_NEAR(lagrange(p.x, points), p.y, std::abs(p.y * 0.001 / 100.0));
     }
 }
+
+TEST(BarycentricTest, AgreesWithLagrange)
+{
+    const std::vector<Point> points{{0, 1}, {2, 5}, {4, 17}, {6, 7}, {7.5, -3}, {9, 2}};
+    const auto [X, Y] = splitCoordinates(points);
+    const auto W = barycentricWeights(X);
+    for(double x = -1.; x <= 10.; x += .13)
+    {
+        const auto expected = lagrange(x, X, Y);
+        EXPECT_NEAR(barycentric(x, X, W, Y), expected, std::abs(expected) * 1e-9 + 1e-9);
+    }
+    // the polynomial passes through the nodes
+    for(const auto& p : points)
+    {
+        EXPECT_EQ(barycentric(p.x, X, W, Y), p.y);
+    }
+}
+
+TEST(BarycentricTest, SubdivisionAgreesWithLagrange)
+{
+    const std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}};
+    const auto [X, Y] = splitCoordinates(points);
+    const std::vector<double> T{0., 1., 2., 3., 4.};
+    std::vector<double> tToEval{};
+    for(double t = 0.; t <= 4.; t += .05)
+    {
+        tToEval.push_back(t);
+    }
+    const auto expected = applyLagrangeSubdivision(X, Y, T, tToEval);
+    const auto res = applyBarycentricSubdivision(X, Y, T, barycentricWeights(T), tToEval);
+    ASSERT_EQ(res.size(), expected.size());
+    for(std::size_t i{0}; i < res.size(); ++i)
+    {
+        EXPECT_NEAR(glm::distance(res[i], expected[i]), 0, 1e-9);
+    }
+}
+
+TEST(LagrangeTest, SubdivisionReusesItsWorkspace)
+{
+    const std::vector<double> X{1.6, 4.6, 1.6, -2.4, -8.4};
+    const std::vector<double> Y{4.25, 8.25, 14.25, 1.25, -6.75};
+    const std::vector<double> T{0., 1., 2., 3., 4.};
+    // enough values for several ranges evaluated concurrently
+    std::vector<double> tToEval(10000);
+    for(std::size_t i{0}; i < tToEval.size(); ++i)
+    {
+        tToEval[i] = static_cast<double>(i) * 4e-4;
+    }
+    const auto expected = applyLagrangeSubdivision(X, Y, T, tToEval);
+    std::vector<Point> curve{};
+    LagrangeWorkspace workspace{};
+    applyLagrangeSubdivision(X, Y, T, tToEval, curve, workspace);
+    const auto before = allocationCount();
+    applyLagrangeSubdivision(X, Y, T, tToEval, curve, workspace);
+    EXPECT_EQ(allocationCount() - before, 0u);
+    ASSERT_EQ(curve.size(), expected.size());
+    for(std::size_t i{0}; i < curve.size(); ++i)
+    {
+        EXPECT_EQ(curve[i], expected[i]);
+    }
+}
+
+TEST(NewtonPolynomialTest, AgreesWithLagrange)
+{
+    const std::vector<Point> points{{0, 1}, {2, 5}, {4, 17}, {6, 7}, {7.5, -3}, {9, 2}};
+    const auto [X, Y] = splitCoordinates(points);
+    NewtonPolynomial<double> polynomial;
+    polynomial.build(X, Y);
+    EXPECT_EQ(polynomial.size(), points.size());
+    for(double x = -1.; x <= 10.; x += .13)
+    {
+        const auto expected = lagrange(x, X, Y);
+        EXPECT_NEAR(polynomial(x), expected, std::abs(expected) * 1e-9 + 1e-9);
+    }
+}
+
+TEST(NewtonPolynomialTest, IncrementalUpdates)
+{
+    const std::vector<double> T{0., 1.5, 2., 3.25, 4.};
+    std::vector<Point> values{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}};
+    NewtonPolynomial<Point> polynomial;
+    NewtonPolynomial<Point> expected;
+    // appending the nodes one by one gives the same polynomial as the whole set
+    for(std::size_t i{0}; i < T.size(); ++i)
+    {
+        polynomial.append(T[i], values[i]);
+        expected.build({T.begin(), std::next(T.begin(), static_cast<long>(i + 1))},
+                       {values.begin(), std::next(values.begin(), static_cast<long>(i + 1))});
+        for(double t = 0.; t <= 4.; t += .1)
+        {
+            EXPECT_NEAR(glm::distance(polynomial(t), expected(t)), 0, 1e-9);
+        }
+    }
+    // moving the last node only recomputes the last diagonal
+    auto movedT = T;
+    for(const auto& [t, p] : std::vector<std::pair<double, Point>>{{5., {1., 2.}}, {4.5, {-3., 7.}}, {6., {0., 0.}}})
+    {
+        movedT.back() = t;
+        values.back() = p;
+        polynomial.updateLast(t, p);
+        expected.build(movedT, values);
+        for(double x = 0.; x <= 6.; x += .1)
+        {
+            EXPECT_NEAR(glm::distance(polynomial(x), expected(x)), 0, 1e-9);
+        }
+        const auto [X, Y] = splitCoordinates(values);
+        EXPECT_NEAR(polynomial(t).x, lagrange(t, movedT, X), 1e-9);
+        EXPECT_NEAR(polynomial(t).y, lagrange(t, movedT, Y), 1e-9);
+    }
+}
+
+TEST(LagrangeTest, SubdivisionAgreesWithLagrange)
+{
+    const std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}, {3., 2.}};
+    const auto [X, Y] = splitCoordinates(points);
+    const std::vector<double> T{0., .5, 2., 3., 4.5, 5.};
+    // an odd number of samples, some of them on the nodes
+    std::vector<double> tToEval{};
+    for(double t = -.3; t <= 5.3; t += .1)
+    {
+        tToEval.push_back(t);
+    }
+    tToEval.insert(tToEval.end(), T.begin(), T.end());
+    const auto res = applyLagrangeSubdivision(X, Y, T, tToEval);
+    const auto resBarycentric = applyBarycentricSubdivision(X, Y, T, barycentricWeights(T), tToEval);
+    ASSERT_EQ(res.size(), tToEval.size());
+    ASSERT_EQ(resBarycentric.size(), tToEval.size());
+    for(std::size_t i{0}; i < res.size(); ++i)
+    {
+        const Point expected{lagrange(tToEval[i], T, X), lagrange(tToEval[i], T, Y)};
+        EXPECT_NEAR(glm::distance(res[i], expected), 0, 1e-9);
+        EXPECT_NEAR(glm::distance(resBarycentric[i], expected), 0, 1e-9);
+    }
+}
+
+TEST(NewtonPolynomialTest, SubdivisionAgreesWithLagrange)
+{
+    const std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}};
+    const auto [X, Y] = splitCoordinates(points);
+    const std::vector<double> T{0., 1.5, 2., 3.25, 4.};
+    NewtonPolynomial<Point> polynomial;
+    polynomial.build(T, points);
+    std::vector<double> tToEval{};
+    for(double t = 0.; t <= 4.; t += .07)
+    {
+        tToEval.push_back(t);
+    }
+    const auto res = applyNewtonSubdivision(polynomial.getNodes(), polynomial.getCoefficients(), tToEval);
+    ASSERT_EQ(res.size(), tToEval.size());
+    for(std::size_t i{0}; i < res.size(); ++i)
+    {
+        const Point expected{lagrange(tToEval[i], T, X), lagrange(tToEval[i], T, Y)};
+        EXPECT_NEAR(glm::distance(res[i], expected), 0, 1e-9);
+    }
+}
+
+TEST(BarycentricTest, WorkspaceOverloadAgrees)
+{
+    const std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}};
+    const auto [X, Y] = splitCoordinates(points);
+    const auto W = barycentricWeights({0., 1., 2., 3., 4.});
+    const auto [T, tToEval] = uniformSubdivision(points.size(), .05);
+    // the output is resized, whatever its previous content
+    std::vector<Point> out(3, Point{1, 1});
+    applyBarycentricSubdivision(X, Y, T, W, tToEval, out);
+    const auto expected = applyBarycentricSubdivision(X, Y, T, W, tToEval);
+    ASSERT_EQ(out.size(), expected.size());
+    for(std::size_t i{0}; i < out.size(); ++i)
+    {
+        EXPECT_EQ(out[i], expected[i]);
+    }
+}
+
+TEST(WindowedLagrangeTest, WholeWindowAgreesWithBarycentric)
+{
+    const std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}, {3., 2.}};
+    const auto [X, Y] = splitCoordinates(points);
+    const auto [T, tToEval] = uniformSubdivision(points.size(), .05);
+    const auto expected = applyBarycentricSubdivision(X, Y, T, barycentricWeights(T), tToEval);
+    for(const auto window : std::vector<std::size_t>{0, 6, 10})
+    {
+        const auto res = applyWindowedLagrangeSubdivision(X, Y, T, window, tToEval);
+        ASSERT_EQ(res.size(), expected.size());
+        for(std::size_t i{0}; i < res.size(); ++i)
+        {
+            EXPECT_NEAR(glm::distance(res[i], expected[i]), 0, 1e-9);
+        }
+    }
+}
+
+TEST(WindowedLagrangeTest, AgreesWithLagrangeOfTheClosestNodes)
+{
+    std::vector<double> X{};
+    std::vector<double> Y{};
+    const std::vector<double> T{0., .7, 1.5, 2.1, 3.4, 4., 5.2, 6.1, 7.3, 8., 9.6, 10.1, 11.};
+    for(std::size_t i{0}; i < T.size(); ++i)
+    {
+        const auto x = static_cast<double>(i);
+        X.push_back(10. * x + std::sin(x));
+        Y.push_back(x * x - 6. * x);
+    }
+    // increasing values, including the nodes and values outside of them, then values jumping back and forth
+    std::vector<double> tToEval{};
+    for(double t = -.5; t <= 11.5; t += .037)
+    {
+        tToEval.push_back(t);
+    }
+    tToEval.insert(tToEval.end(), T.begin(), T.end());
+    tToEval.insert(tToEval.end(), {9.9, .2, 5.5, 10.7, 2.6, 3.8, 0.});
+    for(const auto window : std::vector<std::size_t>{1, 2, 3, 4, 7})
+    {
+        const auto res = applyWindowedLagrangeSubdivision(X, Y, T, window, tToEval);
+        ASSERT_EQ(res.size(), tToEval.size());
+        for(std::size_t i{0}; i < res.size(); ++i)
+        {
+            const auto t = tToEval[i];
+            // the window nodes by brute force
+            std::vector<std::size_t> closest{};
+            for(std::size_t j{0}; j < T.size(); ++j)
+            {
+                closest.push_back(j);
+            }
+            std::stable_sort(closest.begin(), closest.end(), [&](std::size_t a, std::size_t b) {
+                return std::abs(T[a] - t) < std::abs(T[b] - t);
+            });
+            closest.resize(window);
+            std::vector<double> localT{};
+            std::vector<double> localX{};
+            std::vector<double> localY{};
+            for(const auto j : closest)
+            {
+                localT.push_back(T[j]);
+                localX.push_back(X[j]);
+                localY.push_back(Y[j]);
+            }
+            const Point expected{lagrange(t, localT, localX), lagrange(t, localT, localY)};
+            EXPECT_NEAR(glm::distance(res[i], expected), 0, 1e-9) << "window " << window << " t " << t;
+        }
+    }
+}
+
+TEST(WindowedLagrangeTest, DecreasingNodes)
+{
+    const std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}, {3., 2.},
+                                    {5., -1.}, {7.5, 3.}, {9., 6.}};
+    const auto [X, Y] = splitCoordinates(points);
+    // the Chebycheff nodes are decreasing
+    const auto [T, tToEval] = chebycheffSubdivision(.01, points);
+    ASSERT_GT(T.front(), T.back());
+    std::vector<double> reversedT(T.rbegin(), T.rend());
+    std::vector<double> reversedX(X.rbegin(), X.rend());
+    std::vector<double> reversedY(Y.rbegin(), Y.rend());
+    const auto res = applyWindowedLagrangeSubdivision(X, Y, T, 4, tToEval);
+    const auto expected = applyWindowedLagrangeSubdivision(reversedX, reversedY, reversedT, 4, tToEval);
+    ASSERT_EQ(res.size(), expected.size());
+    for(std::size_t i{0}; i < res.size(); ++i)
+    {
+        EXPECT_NEAR(glm::distance(res[i], expected[i]), 0, 1e-9);
+    }
+}
+
+TEST(InterpolationCurveTest, WindowedCurves)
+{
+    InterpolationCurve curve(InterpolationCurve::Parameters(0, 100, .05, 4));
+    InterpolationCurve global(InterpolationCurve::Parameters(0, 100, .05));
+    for(std::size_t i{0}; i < 12; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        curve.add({x * 10., x * x - 4. * x});
+        global.add({x * 10., x * x - 4. * x});
+    }
+    const auto [X, Y] = splitCoordinates(curve.getControlPoints());
+    const auto [T, tToEval] = distanceSubdivision(.05, curve.getControlPoints());
+    const auto expected = applyWindowedLagrangeSubdivision(X, Y, T, 4, tToEval);
+    // moving a point while windowed, then going back to the global polynomial
+    curve.updateControlPointAtIndex(11, {110., 80.}, 1);
+    curve.updateControlPointAtIndex(11, {110., 77.}, 1);
+    const auto& res = curve.getDistanceCurve();
+    ASSERT_EQ(res.size(), expected.size());
+    for(std::size_t i{0}; i < res.size(); ++i)
+    {
+        EXPECT_NEAR(glm::distance(res[i], expected[i]), 0, 1e-9);
+    }
+    auto parameters = curve.getParameters();
+    parameters.window = 0;
+    curve.setParameters(parameters);
+    global.updateControlPointAtIndex(11, {110., 77.}, 1);
+    for(const auto getCurve : {&InterpolationCurve::getUniformCurve,
+                               &InterpolationCurve::getDistanceCurve,
+                               &InterpolationCurve::getRootDistanceCurve,
+                               &InterpolationCurve::getChebycheffCurve})
+    {
+        const auto& windowed = (curve.*getCurve)();
+        const auto& exp = (global.*getCurve)();
+        ASSERT_EQ(windowed.size(), exp.size());
+        for(std::size_t i{0}; i < windowed.size(); ++i)
+        {
+            EXPECT_NEAR(glm::distance(windowed[i], exp[i]), 0, 1e-6);
+        }
+    }
+}
+
+TEST(InterpolationCurveTest, SetControlPointsAgreesWithAdding)
+{
+    const InterpolationCurve::Parameters param(0, 100, .05);
+    std::vector<Point> points{};
+    InterpolationCurve expected(param);
+    for(std::size_t i{0}; i < 9; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        points.emplace_back(x * 10., x * x - 4. * x);
+        expected.add(points.back());
+    }
+    // the curves computed from the previous points are outdated
+    InterpolationCurve curve(param);
+    curve.add({0., 0.});
+    curve.add({50., 20.});
+    curve.update();
+    curve.setControlPoints(points);
+    EXPECT_EQ(curve.getControlPoints(), points);
+    EXPECT_EQ(curve.getCoordinateArrays().size(), points.size());
+    EXPECT_EQ(curve.getIndexClosestPoint({30.2, -3.}, 1.), 3u);
+    for(const auto getCurve : {&InterpolationCurve::getFunctionalCurve,
+                               &InterpolationCurve::getUniformCurve,
+                               &InterpolationCurve::getDistanceCurve,
+                               &InterpolationCurve::getRootDistanceCurve,
+                               &InterpolationCurve::getChebycheffCurve})
+    {
+        const auto& res = (curve.*getCurve)();
+        const auto& exp = (expected.*getCurve)();
+        ASSERT_EQ(res.size(), exp.size());
+        for(std::size_t i{0}; i < res.size(); ++i)
+        {
+            EXPECT_NEAR(glm::distance(res[i], exp[i]), 0, 1e-9);
+        }
+    }
+}
+
+TEST(InterpolationCurveTest, RejectsAFunctionalStepNotAdvancing)
+{
+    // the step is positive but lost in the rounding of x
+    InterpolationCurve curve({5., 5., std::numeric_limits<double>::min()});
+    curve.add({5., 0.});
+    curve.add({5., 1.});
+    EXPECT_THROW(static_cast<void>(curve.getFunctionalCurve()), std::invalid_argument);
+    curve.setParameters({1e16, 1e16 + 10., 1.});
+    EXPECT_THROW(static_cast<void>(curve.getFunctionalCurve()), std::invalid_argument);
+    curve.setParameters({0., 10., 1.});
+    curve.setControlPoints({{0., 0.}, {10., 1.}});
+    EXPECT_EQ(curve.getFunctionalCurve().size(), 11u);
+}
+
+TEST(InterpolationCurveTest, MovingAPointDoesNotAllocatePerSample)
+{
+    // the number of allocations of a drag frame must not depend on the number of samples
+    for(const double step : {.01, .0001})
+    {
+        InterpolationCurve curve(InterpolationCurve::Parameters(0, 100, step));
+        for(std::size_t i{0}; i < 8; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            curve.add({x * 10., x * x - 4. * x});
+        }
+        curve.update();
+        // the first frame after the edit sizes the workspaces
+        curve.updateControlPointAtIndex(3, {30., 5.}, 1);
+        curve.update();
+        const auto before = allocationCount();
+        curve.updateControlPointAtIndex(3, {31., 6.}, 1);
+        curve.update();
+        // with or without the thread pool, see the curves__interpolation_test.pool tests
+        EXPECT_EQ(allocationCount() - before, 0u);
+        EXPECT_FALSE(curve.getUniformCurve().empty());
+    }
+}
+
+TEST(InterpolationCurveTest, IncrementalEditsAgreeWithComputation)
+{
+    const InterpolationCurve::Parameters param(0, 100, .01);
+    InterpolationCurve curve(param);
+    for(std::size_t i{0}; i < 6; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        curve.add({x * 10., x * x - 4. * x});
+    }
+    curve.update();
+    // a point in the middle moved several times, the appended point moved, then the first point moved
+    const std::vector<std::pair<std::size_t, Point>> moves{
+        {2, {22., 3.}}, {2, {25., -1.}}, {6, {70., 12.}}, {6, {72., 15.}}, {0, {-3., 2.}}};
+    for(const auto& [idx, p] : moves)
+    {
+        if(idx == curve.size())
+        {
+            curve.add(p);
+        }
+        else
+        {
+            curve.updateControlPointAtIndex(idx, p, 1);
+        }
+        curve.update();
+        InterpolationCurve expected(param);
+        for(const auto& q : curve.getControlPoints())
+        {
+            expected.add(q);
+        }
+        for(const auto getCurve : {&InterpolationCurve::getDistanceCurve, &InterpolationCurve::getRootDistanceCurve})
+        {
+            const auto& res = (curve.*getCurve)();
+            const auto& exp = (expected.*getCurve)();
+            ASSERT_EQ(res.size(), exp.size());
+            for(std::size_t i{0}; i < res.size(); ++i)
+            {
+                EXPECT_NEAR(glm::distance(res[i], exp[i]), 0, 1e-6);
+            }
+        }
+    }
+}
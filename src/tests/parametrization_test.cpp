@@ -206,3 +206,60 @@ TEST(ChebycheffSubdivisionTest, CheckOutput)
         }
     }
 }
+
+TEST(SubdivisionTest, WorkspaceOverloadsReuseTheOutputs)
+{
+    const std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}};
+    // the outputs are resized, whatever their previous content
+    std::vector<double> T(12, 1.);
+    std::vector<double> tToEval(1, 2.);
+    distanceSubdivision(.03, points, T, tToEval);
+    const auto [expectedT, expectedSamples] = distanceSubdivision(.03, points);
+    EXPECT_EQ(T, expectedT);
+    EXPECT_EQ(tToEval, expectedSamples);
+    rootDistanceSubdivision(.03, points, T, tToEval);
+    const auto [expectedRootT, expectedRootSamples] = rootDistanceSubdivision(.03, points);
+    EXPECT_EQ(T, expectedRootT);
+    EXPECT_EQ(tToEval, expectedRootSamples);
+    chebycheffSubdivision(.03, points, T, tToEval);
+    const auto [expectedChebycheffT, expectedChebycheffSamples] = chebycheffSubdivision(.03, points);
+    EXPECT_EQ(T, expectedChebycheffT);
+    EXPECT_EQ(tToEval, expectedChebycheffSamples);
+}
+
+TEST(SubdivisionTest, SinglePointUpdatesAgreeWithComputation)
+{
+    std::vector<Point> points{{1.6, 4.25}, {4.6, 8.25}, {1.6, 14.25}, {-2.4, 1.25}, {-8.4, -6.75}};
+    auto T = computeDistanceSubdivision(points);
+    auto rootT = computeRootDistanceSubdivision(points);
+    for(std::size_t idx{0}; idx < points.size(); ++idx)
+    {
+        points[idx] += Point{.7, -1.3};
+        updateDistanceSubdivision(points, idx, T);
+        updateRootDistanceSubdivision(points, idx, rootT);
+        const auto expected = computeDistanceSubdivision(points);
+        const auto expectedRoot = computeRootDistanceSubdivision(points);
+        for(std::size_t i{0}; i < points.size(); ++i)
+        {
+            EXPECT_NEAR(T[i], expected[i], 1e-12);
+            EXPECT_NEAR(rootT[i], expectedRoot[i], 1e-12);
+        }
+    }
+    // an appended point only needs its own node
+    points.emplace_back(3., 3.);
+    T.push_back(0);
+    updateDistanceSubdivision(points, points.size() - 1, T);
+    const auto expected = computeDistanceSubdivision(points);
+    EXPECT_NEAR(T.back(), expected.back(), 1e-12);
+}
+
+TEST(SubdivisionTest, SamplesKeepTheirPrefix)
+{
+    std::vector<double> tToEval{};
+    for(const double end : {2.05, 3.5, 3., 1.25, 1.2, 4.})
+    {
+        const std::vector<double> T{0., end * .5, end};
+        createSamples(.1, T, tToEval, true);
+        EXPECT_EQ(tToEval, createSamples(.1, T));
+    }
+}
@@ -0,0 +1,120 @@
+#include <curves/PointSetFile.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+std::string temporaryFile(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / ("curves_" + name)).string();
+}
+
+std::vector<std::vector<Point>> makeSets()
+{
+    std::vector<std::vector<Point>> sets{};
+    for(std::size_t s{0}; s < 5; ++s)
+    {
+        std::vector<Point> points{};
+        // sets of odd sizes, so that the next set needs padding, and an empty set
+        for(std::size_t i{0}; i < 2 * s + 1 && s != 3; ++i)
+        {
+            points.emplace_back(static_cast<double>(i) + .5, static_cast<double>(s) - .25);
+        }
+        sets.push_back(points);
+    }
+    return sets;
+}
+}
+
+TEST(PointSetFileTest, WriteAndMap)
+{
+    const auto filename = temporaryFile("doubles.cpts");
+    const auto sets = makeSets();
+    {
+        PointSetWriter writer(filename);
+        for(std::size_t s{0}; s < sets.size(); ++s)
+        {
+            writer.write(sets[s], 10 + s);
+        }
+        EXPECT_EQ(writer.size(), sets.size());
+        writer.finish();
+    }
+    {
+        const PointSetFile file(filename);
+        ASSERT_EQ(file.size(), sets.size());
+        EXPECT_EQ(file.getScalar(), PointSetScalar::Float64);
+        for(std::size_t s{0}; s < sets.size(); ++s)
+        {
+            const auto points = file.points(s);
+            ASSERT_EQ(points.size(), sets[s].size());
+            for(std::size_t i{0}; i < points.size(); ++i)
+            {
+                EXPECT_EQ(points[i], sets[s][i]);
+            }
+            EXPECT_EQ(file.tag(s), 10 + s);
+        }
+        EXPECT_THROW((void)file.points(sets.size()), std::out_of_range);
+        EXPECT_THROW((void)file.floatPoints(0), std::runtime_error);
+    }
+    std::filesystem::remove(filename);
+}
+
+TEST(PointSetFileTest, Floats)
+{
+    const auto filename = temporaryFile("floats.cpts");
+    const auto sets = makeSets();
+    {
+        // finished by the destructor
+        PointSetWriter writer(filename, PointSetScalar::Float32);
+        for(const auto& set : sets)
+        {
+            writer.write(set);
+        }
+    }
+    {
+        const PointSetFile file(filename);
+        ASSERT_EQ(file.size(), sets.size());
+        EXPECT_EQ(file.getScalar(), PointSetScalar::Float32);
+        std::vector<Point> points;
+        for(std::size_t s{0}; s < sets.size(); ++s)
+        {
+            EXPECT_EQ(file.floatPoints(s).size(), sets[s].size());
+            file.read(s, points);
+            ASSERT_EQ(points.size(), sets[s].size());
+            for(std::size_t i{0}; i < points.size(); ++i)
+            {
+                // the coordinates are exact in single precision
+                EXPECT_EQ(points[i], sets[s][i]);
+            }
+        }
+    }
+    std::filesystem::remove(filename);
+}
+
+TEST(PointSetFileTest, InvalidFiles)
+{
+    EXPECT_THROW(PointSetFile(temporaryFile("missing.cpts")), std::runtime_error);
+
+    const auto filename = temporaryFile("invalid.cpts");
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file << "0 0\n1 1\n2 2\n3 3\n4 4\n5 5\n6 6\n7 7\n8 8\n";
+    }
+    EXPECT_THROW(PointSetFile{filename}, std::runtime_error);
+    std::filesystem::remove(filename);
+
+    // truncated file, the index table is missing
+    {
+        PointSetWriter writer(filename);
+        writer.write(makeSets()[2]);
+    }
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 8);
+    EXPECT_THROW(PointSetFile{filename}, std::runtime_error);
+    std::filesystem::remove(filename);
+}
@@ -0,0 +1,271 @@
+#include <curves/InterpolationCurve.h>
+#include <curves/sampling.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace {
+/// a polynomial going above and below a 800x600 window
+double wave(double x)
+{
+    const auto u = (x - 400.) / 100.;
+    return 300. + 40. * u * (u * u - 4.) * (u * u - 9.) / 10.;
+}
+
+/**
+ * @return the largest distance between the graph sampled every 0.01 and the polyline, ignoring the points of the graph
+ * outside of the viewport
+ */
+double maxDeviation(const std::function<double(double)>& f,
+                    const std::vector<Point>& polyline,
+                    const Viewport& viewport)
+{
+    double res{0};
+    std::size_t segment{0};
+    for(auto x = polyline.front().x; x <= polyline.back().x; x += .01)
+    {
+        while(segment + 2 < polyline.size() && polyline[segment + 1].x < x)
+        {
+            ++segment;
+        }
+        const Point p{x, f(x)};
+        if(p.y < viewport.ymin || p.y > viewport.ymax)
+        {
+            continue;
+        }
+        const auto& a = polyline[segment];
+        const auto& b = polyline[segment + 1];
+        const auto chord = b - a;
+        res = std::max(res, std::abs(chord.x * (p.y - a.y) - chord.y * (p.x - a.x)) / glm::length(chord));
+    }
+    return res;
+}
+}
+
+TEST(AdaptiveFunctionSamplingTest, StaysWithinTheTolerance)
+{
+    std::vector<Point> polyline{};
+    for(const double tolerance : {2., .25, .05})
+    {
+        adaptiveFunctionSampling(&wave, 0, 800, Viewport{}, tolerance, polyline);
+        ASSERT_GE(polyline.size(), 2u);
+        EXPECT_EQ(polyline.front().x, 0.);
+        EXPECT_EQ(polyline.back().x, 800.);
+        for(std::size_t i{1}; i < polyline.size(); ++i)
+        {
+            EXPECT_LT(polyline[i - 1].x, polyline[i].x);
+            EXPECT_EQ(polyline[i].y, wave(polyline[i].x));
+        }
+        // the middle point is a heuristic, the cubic terms of the graph can move the largest distance a bit
+        EXPECT_LE(maxDeviation(&wave, polyline, Viewport{}), 1.1 * tolerance) << "tolerance " << tolerance;
+    }
+}
+
+TEST(AdaptiveFunctionSamplingTest, StopsAtTheViewport)
+{
+    const Viewport viewport{0, 0, 800, 600};
+    std::vector<Point> clipped{};
+    adaptiveFunctionSampling(&wave, -200, 1000, viewport, .25, clipped);
+    std::vector<Point> unclipped{};
+    adaptiveFunctionSampling(&wave, 0, 800, Viewport{}, .25, unclipped);
+    ASSERT_GE(clipped.size(), 2u);
+    EXPECT_EQ(clipped.front().x, 0.);
+    EXPECT_EQ(clipped.back().x, 800.);
+    EXPECT_LE(maxDeviation(&wave, clipped, viewport), .3);
+    // the parts of the graph above and below the window are not refined
+    EXPECT_LT(clipped.size(), unclipped.size());
+    // a fraction of the samples of a step of 0.05 pixel
+    EXPECT_LT(clipped.size(), 800 / .05 / 20);
+}
+
+TEST(AdaptiveFunctionSamplingTest, EmptyOutsideOfTheViewport)
+{
+    std::vector<Point> polyline{{1, 1}};
+    adaptiveFunctionSampling(&wave, 900, 1000, Viewport{0, 0, 800, 600}, .25, polyline);
+    EXPECT_TRUE(polyline.empty());
+}
+
+namespace {
+/// a spiral of radius 100 to 300 pixels
+void spiral(const std::vector<double>& tToEval, std::vector<Point>& curve)
+{
+    curve.resize(tToEval.size());
+    for(std::size_t i{0}; i < tToEval.size(); ++i)
+    {
+        const auto t = tToEval[i];
+        curve[i] = Point{std::cos(t), std::sin(t)} * (100. + 10. * t);
+    }
+}
+
+/**
+ * @return the largest distance between the curve sampled every 0.001 and the polyline
+ */
+double maxDeviation(const CurveEvaluator& evaluate, const std::vector<double>& tToEval, const std::vector<Point>& curve)
+{
+    double res{0};
+    std::vector<double> t{};
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i + 1 < tToEval.size(); ++i)
+    {
+        t.clear();
+        for(auto u = tToEval[i]; u < tToEval[i + 1]; u += .001)
+        {
+            t.push_back(u);
+        }
+        evaluate(t, points);
+        const auto chord = curve[i + 1] - curve[i];
+        for(const auto& p : points)
+        {
+            const auto s = std::clamp(glm::dot(p - curve[i], chord) / glm::dot(chord, chord), 0., 1.);
+            res = std::max(res, glm::distance(p, curve[i] + s * chord));
+        }
+    }
+    return res;
+}
+}
+
+TEST(AdaptiveCurveSamplingTest, StaysWithinTheTolerance)
+{
+    // unordered nodes
+    const std::vector<double> T{20., 0., 5., 10., 15.};
+    std::vector<double> tToEval{};
+    std::vector<Point> curve{};
+    CurveSamplingWorkspace workspace{};
+    std::size_t previousSize{0};
+    for(const double tolerance : {2., .25, .05})
+    {
+        adaptiveCurveSampling(&spiral, T, tolerance, 100000, tToEval, curve, workspace);
+        ASSERT_EQ(tToEval.size(), curve.size());
+        EXPECT_EQ(tToEval.front(), 0.);
+        EXPECT_EQ(tToEval.back(), 20.);
+        for(std::size_t i{1}; i < tToEval.size(); ++i)
+        {
+            EXPECT_LT(tToEval[i - 1], tToEval[i]);
+        }
+        // the nodes are kept
+        for(const auto t : T)
+        {
+            EXPECT_TRUE(std::binary_search(tToEval.begin(), tToEval.end(), t));
+        }
+        EXPECT_LE(maxDeviation(&spiral, tToEval, curve), 1.1 * tolerance) << "tolerance " << tolerance;
+        EXPECT_GT(curve.size(), previousSize);
+        previousSize = curve.size();
+    }
+}
+
+TEST(AdaptiveCurveSamplingTest, EvaluatesALevelAtOnce)
+{
+    std::size_t calls{0};
+    const CurveEvaluator evaluate = [&calls](const std::vector<double>& tToEval, std::vector<Point>& curve) {
+        ++calls;
+        spiral(tToEval, curve);
+    };
+    std::vector<double> tToEval{};
+    std::vector<Point> curve{};
+    CurveSamplingWorkspace workspace{};
+    const std::vector<double> T{0., 20.};
+    adaptiveCurveSampling(evaluate, T, .25, 100000, tToEval, curve, workspace, 10);
+    // the nodes, then one call per level
+    EXPECT_LE(calls, 11u);
+    EXPECT_GT(tToEval.size(), 100u);
+}
+
+TEST(AdaptiveCurveSamplingTest, CapsTheNumberOfVertices)
+{
+    const std::vector<double> T{0., 10., 20.};
+    std::vector<double> tToEval{};
+    std::vector<Point> curve{};
+    CurveSamplingWorkspace workspace{};
+    adaptiveCurveSampling(&spiral, T, .01, 100000, tToEval, curve, workspace);
+    const auto uncapped = tToEval.size();
+    for(const std::size_t maxVertices : {std::size_t{2}, std::size_t{3}, std::size_t{50}, std::size_t{333}})
+    {
+        adaptiveCurveSampling(&spiral, T, .01, maxVertices, tToEval, curve, workspace);
+        ASSERT_LT(maxVertices, uncapped);
+        // the nodes are always kept
+        EXPECT_EQ(tToEval.size(), std::max<std::size_t>(maxVertices, T.size()));
+        EXPECT_EQ(curve.size(), tToEval.size());
+    }
+    // the intervals farthest from their chord are split first, the outer part of the spiral being more curved in t
+    const std::vector<double> ends{0., 20.};
+    adaptiveCurveSampling(&spiral, ends, .01, 40, tToEval, curve, workspace);
+    const auto outer = std::count_if(tToEval.begin(), tToEval.end(), [](double t) { return t > 10.; });
+    EXPECT_GT(static_cast<std::size_t>(outer), tToEval.size() / 2);
+}
+
+TEST(InterpolationCurveTest, AdaptiveParametricCurves)
+{
+    InterpolationCurve::Parameters param(0, 800, .001);
+    InterpolationCurve fixed(param);
+    param.sampling = InterpolationCurve::Sampling::Adaptive;
+    param.tolerance = .25;
+    InterpolationCurve adaptive(param);
+    for(const auto& p : std::vector<Point>{{100, 300}, {250, 420}, {400, 150}, {550, 380}, {700, 310}, {600, 100}})
+    {
+        fixed.add(p);
+        adaptive.add(p);
+    }
+    for(const auto getCurve : {&InterpolationCurve::getUniformCurve,
+                               &InterpolationCurve::getDistanceCurve,
+                               &InterpolationCurve::getRootDistanceCurve,
+                               &InterpolationCurve::getChebycheffCurve})
+    {
+        const auto& res = (adaptive.*getCurve)();
+        const auto& expected = (fixed.*getCurve)();
+        ASSERT_GE(res.size(), 6u);
+        EXPECT_LT(res.size() * 20, expected.size());
+        EXPECT_EQ(res.front(), expected.front());
+        // each point of the dense sampling is close to the polyline
+        for(const auto& p : expected)
+        {
+            double distance{std::numeric_limits<double>::infinity()};
+            for(std::size_t i{0}; i + 1 < res.size(); ++i)
+            {
+                const auto chord = res[i + 1] - res[i];
+                const auto s = std::clamp(glm::dot(p - res[i], chord) / glm::dot(chord, chord), 0., 1.);
+                distance = std::min(distance, glm::distance(p, res[i] + s * chord));
+            }
+            EXPECT_LE(distance, .3);
+        }
+    }
+}
+
+TEST(InterpolationCurveTest, AdaptiveFunctionalCurve)
+{
+    InterpolationCurve::Parameters param(0, 800, .05);
+    InterpolationCurve fixed(param);
+    param.sampling = InterpolationCurve::Sampling::Adaptive;
+    param.tolerance = .25;
+    param.viewport = {0, 0, 800, 600};
+    InterpolationCurve adaptive(param);
+    for(const auto& p : std::vector<Point>{{100, 300}, {250, 420}, {400, 150}, {550, 380}, {700, 310}})
+    {
+        fixed.add(p);
+        adaptive.add(p);
+    }
+    const auto& res = adaptive.getFunctionalCurve();
+    const auto& expected = fixed.getFunctionalCurve();
+    EXPECT_LT(res.size() * 20, expected.size());
+    // the fixed samples within the window are close to the adaptive polyline
+    std::size_t segment{0};
+    for(const auto& p : expected)
+    {
+        if(p.y < 0 || p.y > 600)
+        {
+            continue;
+        }
+        while(segment + 2 < res.size() && res[segment + 1].x < p.x)
+        {
+            ++segment;
+        }
+        const auto& a = res[segment];
+        const auto& b = res[segment + 1];
+        const auto chord = b - a;
+        EXPECT_LE(std::abs(chord.x * (p.y - a.y) - chord.y * (p.x - a.x)) / glm::length(chord), .3) << p.x;
+    }
+}
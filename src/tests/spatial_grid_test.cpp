@@ -0,0 +1,89 @@
+#include <curves/ControlPoints.h>
+#include <curves/SpatialGrid.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+void expectSameAsScan(const ControlPoints& controlPoints, const Point& p, double threshold)
+{
+    EXPECT_EQ(controlPoints.getIndexClosestPoint(p, threshold),
+              getClosestPointIndex(controlPoints.getControlPoints(), p, threshold));
+}
+}
+
+TEST(SpatialGridTest, AgreesWithScan)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-500., 500.);
+    ControlPoints controlPoints;
+    for(std::size_t i{0}; i < 2000; ++i)
+    {
+        controlPoints.add({coordinate(generator), coordinate(generator)});
+    }
+    for(std::size_t k{0}; k < 500; ++k)
+    {
+        const Point p{coordinate(generator), coordinate(generator)};
+        for(const auto threshold : {0., 1., 10., 50., 1e4})
+        {
+            expectSameAsScan(controlPoints, p, threshold);
+        }
+        // moves, deletions and additions keep the index in sync
+        const auto idx = static_cast<std::size_t>(k * 13) % controlPoints.getControlPoints().size();
+        controlPoints.updateControlPointAtIndex(idx, p, 0.);
+        if(k % 3 == 0)
+        {
+            EXPECT_TRUE(controlPoints.deleteControlPoint(p, 0.));
+        }
+        if(k % 5 == 0)
+        {
+            controlPoints.add(p + Point{.5, .5});
+        }
+        expectSameAsScan(controlPoints, p, 1.);
+    }
+}
+
+TEST(SpatialGridTest, TiesGoToTheLowestIndex)
+{
+    ControlPoints controlPoints;
+    // the same point in different cells of the grid
+    controlPoints.setSpatialIndexCellSize(1.);
+    controlPoints.add({3.5, 0.});
+    controlPoints.add({-3.5, 0.});
+    controlPoints.add({0., 3.5});
+    controlPoints.add({0., -3.5});
+    EXPECT_EQ(controlPoints.getIndexClosestPoint({0., 0.}, 4.), 0u);
+    EXPECT_TRUE(controlPoints.deleteControlPoint({3.5, 0.}, .1));
+    EXPECT_EQ(controlPoints.getIndexClosestPoint({0., 0.}, 4.), 0u);
+    EXPECT_EQ(controlPoints.getIndexClosestPoint({0., -3.}, 1.), 2u);
+    EXPECT_FALSE(controlPoints.getIndexClosestPoint({0., 0.}, 3.).has_value());
+    controlPoints.reset();
+    EXPECT_FALSE(controlPoints.getIndexClosestPoint({0., 0.}, 4.).has_value());
+}
+
+TEST(SpatialGridTest, ErasingRenumbersTheFollowingPoints)
+{
+    // points sharing cells, some of them in the cell of the erased point
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i < 40; ++i)
+    {
+        const auto x = static_cast<double>(i % 8);
+        points.emplace_back(x * 10., static_cast<double>(i));
+    }
+    SpatialGrid grid(100.);
+    grid.build(points);
+    for(const std::size_t idx : {5u, 0u, 20u, 36u})
+    {
+        grid.erase(idx, points[idx]);
+        points.erase(points.begin() + static_cast<std::ptrdiff_t>(idx));
+        for(std::size_t i{0}; i < points.size(); ++i)
+        {
+            EXPECT_EQ(grid.closest(points, points[i], 0.), i);
+        }
+    }
+    grid.insert(points.size(), {1., 1.});
+    points.emplace_back(1., 1.);
+    EXPECT_EQ(grid.closest(points, {1., 1.}, 0.), points.size() - 1);
+}
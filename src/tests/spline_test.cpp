@@ -0,0 +1,229 @@
+#include <curves/CubicSpline.h>
+#include <curves/SplineCurve.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+double cubic(double t) { return .5 * t * t * t - 2. * t * t + t - 3.; }
+
+double cubicSlope(double t) { return 1.5 * t * t - 4. * t + 1.; }
+
+std::vector<Point> makeWave(std::size_t nbPoints)
+{
+    std::vector<Point> points{};
+    for(std::size_t i{0}; i < nbPoints; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        points.emplace_back(10. * x, 50. * std::sin(x * .3));
+    }
+    return points;
+}
+}
+
+TEST(CubicSplineTest, InterpolatesTheValues)
+{
+    const std::vector<double> T{0., .5, 2., 2.25, 4., 7.};
+    const std::vector<double> Y{1., -2., 3., 3.5, 0., 2.};
+    for(const auto boundary : {SplineBoundary::Natural, SplineBoundary::Clamped})
+    {
+        CubicSpline<double> spline;
+        spline.build(T, Y, boundary, 1., -1.);
+        for(std::size_t i{0}; i < T.size(); ++i)
+        {
+            EXPECT_NEAR(spline(T[i]), Y[i], 1e-12);
+        }
+    }
+}
+
+TEST(CubicSplineTest, NaturalEndsAreStraight)
+{
+    const std::vector<double> T{0., 1., 3., 4., 6.};
+    const std::vector<double> Y{0., 2., -1., 1., 3.};
+    CubicSpline<double> spline;
+    spline.build(T, Y);
+    EXPECT_EQ(spline.getMoments().front(), 0.);
+    EXPECT_EQ(spline.getMoments().back(), 0.);
+    // values on a line give a line
+    const std::vector<double> line{1., 3., 7., 9., 13.};
+    spline.build(T, line);
+    for(double t = -1.; t <= 7.; t += .1)
+    {
+        EXPECT_NEAR(spline(t), 1. + 2. * t, 1e-12);
+    }
+}
+
+TEST(CubicSplineTest, ClampedReproducesACubic)
+{
+    const std::vector<double> T{-1., 0., .5, 2., 3.};
+    std::vector<double> Y{};
+    for(const auto t : T)
+    {
+        Y.push_back(cubic(t));
+    }
+    CubicSpline<double> spline;
+    spline.build(T, Y, SplineBoundary::Clamped, cubicSlope(T.front()), cubicSlope(T.back()));
+    for(double t = -1.; t <= 3.; t += .05)
+    {
+        EXPECT_NEAR(spline(t), cubic(t), 1e-10);
+    }
+}
+
+TEST(CubicSplineTest, CursorAgreesWithSearch)
+{
+    std::vector<double> T{};
+    std::vector<double> Y{};
+    for(std::size_t i{0}; i < 50; ++i)
+    {
+        const auto t = static_cast<double>(i) + .3 * std::sin(static_cast<double>(i));
+        T.push_back(t);
+        Y.push_back(std::cos(t));
+    }
+    CubicSpline<double> spline;
+    spline.build(T, Y);
+    // forwards, backwards and jumping around, outside of the nodes as well
+    CubicSpline<double>::Cursor cursor(spline, 10.);
+    for(const double t : {10., 10.2, 11., 30., 29.5, 2., -3., 0., 49.3, 60., 48.})
+    {
+        EXPECT_EQ(cursor(t), spline(t));
+    }
+}
+
+TEST(CubicSplineTest, RejectsRepeatedNodes)
+{
+    CubicSpline<double> spline;
+    const std::vector<double> Y{1., 2., 3., 4.};
+    const std::vector<double> repeated{0., 1., 1., 2.};
+    EXPECT_THROW(spline.build(repeated, Y), std::invalid_argument);
+    const std::vector<double> undefined{0., 1., std::nan(""), 2.};
+    EXPECT_THROW(spline.build(undefined, Y), std::invalid_argument);
+    // the values at the repeated nodes are merged first
+    std::vector<double> T{0., 1., 1., 1., 2., 2.};
+    const std::vector<double> values{1., 2., 2., 2., 3., 3.};
+    std::vector<double> merged;
+    const auto distinct = mergeRepeatedNodes<double>(T, values, merged);
+    EXPECT_EQ(T, (std::vector<double>{0., 1., 2.}));
+    ASSERT_EQ(distinct.size(), 3u);
+    EXPECT_EQ(merged, (std::vector<double>{1., 2., 3.}));
+    spline.build(T, distinct);
+    EXPECT_NEAR(spline(1.), 2., 1e-12);
+    // the values are used in place without repeated nodes
+    const std::vector<double> increasing{0., 1., 2., 3.};
+    T = increasing;
+    EXPECT_EQ(mergeRepeatedNodes<double>(T, Y, merged).data(), Y.data());
+    EXPECT_EQ(T, increasing);
+}
+
+TEST(SplineCurveTest, DuplicatedPoints)
+{
+    auto points = makeWave(10);
+    // a point entered twice, e.g. by a double click or in a point-set file
+    points.insert(points.begin() + 4, points[4]);
+    points.push_back(points.back());
+    for(const auto parametrization : {SplineCurve::Parametrization::Uniform,
+                                      SplineCurve::Parametrization::Distance,
+                                      SplineCurve::Parametrization::RootDistance})
+    {
+        SplineCurve curve({.05, parametrization});
+        curve.makeFromVector(points);
+        const auto& res = curve.getCurve();
+        ASSERT_FALSE(res.empty());
+        for(const auto& p : res)
+        {
+            ASSERT_TRUE(std::isfinite(p.x) && std::isfinite(p.y));
+        }
+        const auto& spline = curve.getSpline();
+        for(const auto& p : points)
+        {
+            const auto& nodes = spline.getNodes();
+            EXPECT_TRUE(std::any_of(nodes.begin(), nodes.end(), [&](double t) {
+                return glm::distance(spline(t), p) < 1e-9;
+            }));
+        }
+    }
+    // the curve of a single point entered several times
+    SplineCurve curve({.05, SplineCurve::Parametrization::Distance});
+    curve.makeFromVector({{1., 2.}, {1., 2.}, {1., 2.}});
+    EXPECT_TRUE(curve.getCurve().empty());
+}
+
+TEST(SplineCurveTest, RetriesAfterAFailedBuild)
+{
+    auto points = makeWave(10);
+    SplineCurve curve({.05, SplineCurve::Parametrization::Distance});
+    curve.makeFromVector(points);
+    const auto expected = curve.getCurve();
+    const auto valid = points[4];
+    curve.updateControlPointAtIndex(4, {std::nan(""), 0.}, 0.);
+    // the error is reported on each request instead of returning the previous curve
+    EXPECT_THROW(static_cast<void>(curve.getCurve()), std::invalid_argument);
+    EXPECT_THROW(static_cast<void>(curve.getCurve()), std::invalid_argument);
+    curve.updateControlPointAtIndex(4, valid, 0.);
+    EXPECT_EQ(curve.getCurve(), expected);
+}
+
+TEST(SplineCurveTest, PassesThroughTheControlPoints)
+{
+    const auto points = makeWave(40);
+    for(const auto parametrization : {SplineCurve::Parametrization::Uniform,
+                                      SplineCurve::Parametrization::Distance,
+                                      SplineCurve::Parametrization::RootDistance})
+    {
+        SplineCurve curve({.05, parametrization});
+        curve.makeFromVector(points);
+        const auto& spline = curve.getSpline();
+        ASSERT_EQ(spline.size(), points.size());
+        for(std::size_t i{0}; i < points.size(); ++i)
+        {
+            EXPECT_NEAR(glm::distance(spline(spline.getNodes()[i]), points[i]), 0, 1e-9);
+        }
+        const auto& res = curve.getCurve();
+        ASSERT_FALSE(res.empty());
+        EXPECT_NEAR(glm::distance(res.front(), points.front()), 0, 1e-9);
+        EXPECT_NEAR(glm::distance(res.back(), points.back()), 0, 1e-9);
+    }
+}
+
+TEST(SplineCurveTest, FollowsTheEdits)
+{
+    SplineCurve curve({.1, SplineCurve::Parametrization::Distance});
+    EXPECT_TRUE(curve.getCurve().empty());
+    curve.add({0, 0});
+    EXPECT_TRUE(curve.getCurve().empty());
+    for(const auto& p : makeWave(20))
+    {
+        curve.add(p + Point{5, 0});
+    }
+    curve.updateControlPointAtIndex(7, {72, 30}, 1);
+    EXPECT_TRUE(curve.deleteControlPoint({0, 0}, 1));
+    // the curve is the same as the one of the final points
+    SplineCurve expected({.1, SplineCurve::Parametrization::Distance});
+    expected.makeFromVector(curve.getControlPoints());
+    const auto& res = curve.getCurve();
+    const auto& exp = expected.getCurve();
+    ASSERT_EQ(res.size(), exp.size());
+    for(std::size_t i{0}; i < res.size(); ++i)
+    {
+        EXPECT_NEAR(glm::distance(res[i], exp[i]), 0, 1e-9);
+    }
+    curve.reset();
+    EXPECT_TRUE(curve.getCurve().empty());
+}
+
+TEST(SplineCurveTest, ManyPoints)
+{
+    // the samples are spread over the ranges of the thread pool
+    const auto points = makeWave(200000);
+    SplineCurve curve({1., SplineCurve::Parametrization::Uniform});
+    curve.makeFromVector(points);
+    const auto& res = curve.getCurve();
+    ASSERT_EQ(res.size(), points.size());
+    for(std::size_t i{0}; i < points.size(); i += 997)
+    {
+        EXPECT_NEAR(glm::distance(res[i], points[i]), 0, 1e-6);
+    }
+}
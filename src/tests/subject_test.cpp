@@ -0,0 +1,193 @@
+#include <Subject.h>
+#include <curves/BezierCurve.h>
+#include <curves/CurveChange.h>
+#include <curves/InterpolationCurve.h>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+/// records the events it receives, and runs an action on each of them
+class Recorder : public Observer<int>
+{
+public:
+    void update(const int& event) override
+    {
+        events.push_back(event);
+        if(action)
+        {
+            action(event);
+        }
+    }
+
+    std::vector<int> events{};
+    std::function<void(int)> action{};
+};
+
+/// records the changes of a curve
+class ChangeRecorder : public Observer<CurveChange>
+{
+public:
+    void update(const CurveChange& change) override { changes.push_back(change); }
+
+    std::vector<CurveChange> changes{};
+};
+}
+
+TEST(SubjectTest, NotifiesTheAttachedObservers)
+{
+    Subject<int> subject;
+    const auto first = std::make_shared<Recorder>();
+    const auto second = std::make_shared<Recorder>();
+    subject.attach(first);
+    subject.attach(second);
+    subject.attach(first);
+    EXPECT_EQ(subject.observerCount(), 2u);
+    subject.notify(1);
+    subject.detach(first);
+    subject.notify(2);
+    EXPECT_EQ(first->events, std::vector<int>({1}));
+    EXPECT_EQ(second->events, std::vector<int>({1, 2}));
+    // the copies of the subject have their own observers
+    const Subject<int> copy(subject);
+    EXPECT_EQ(copy.observerCount(), 0u);
+}
+
+TEST(SubjectTest, ObserversModifiedDuringANotification)
+{
+    Subject<int> subject;
+    auto first = std::make_shared<Recorder>();
+    const auto second = std::make_shared<Recorder>();
+    const auto third = std::make_shared<Recorder>();
+    const auto attached = std::make_shared<Recorder>();
+    std::weak_ptr<Recorder> alive = first;
+    // the first observer detaches itself and the second one, and attaches another one
+    first->action = [&](int) {
+        subject.detach(first);
+        subject.detach(second);
+        subject.attach(attached);
+        first.reset();
+        // still held by the subject while it is notified
+        EXPECT_FALSE(alive.expired());
+    };
+    subject.attach(first);
+    subject.attach(second);
+    subject.attach(third);
+    subject.notify(1);
+    EXPECT_TRUE(alive.expired());
+    EXPECT_EQ(subject.observerCount(), 2u);
+    EXPECT_TRUE(second->events.empty());
+    EXPECT_EQ(third->events, std::vector<int>({1}));
+    // the observer attached during the notification only receives the next events
+    EXPECT_TRUE(attached->events.empty());
+    subject.notify(2);
+    EXPECT_EQ(third->events, std::vector<int>({1, 2}));
+    EXPECT_EQ(attached->events, std::vector<int>({2}));
+}
+
+TEST(SubjectTest, NestedNotifications)
+{
+    Subject<int> subject;
+    const auto first = std::make_shared<Recorder>();
+    const auto second = std::make_shared<Recorder>();
+    first->action = [&](int event) {
+        if(event == 1)
+        {
+            subject.detach(first);
+            subject.notify(2);
+        }
+    };
+    subject.attach(first);
+    subject.attach(second);
+    subject.notify(1);
+    EXPECT_EQ(first->events, std::vector<int>({1}));
+    EXPECT_EQ(second->events, std::vector<int>({2, 1}));
+    EXPECT_EQ(subject.observerCount(), 1u);
+}
+
+TEST(CurveChangeTest, MergesTheChangesOfABatch)
+{
+    const CurveChange first{CurveChange::Edit::Move, {4, 5}, {1, 20}};
+    const CurveChange second{CurveChange::Edit::Move, {1, 2}, {1, 10}};
+    const auto moves = first.merge(second);
+    EXPECT_EQ(moves.edit, CurveChange::Edit::Move);
+    EXPECT_EQ(moves.points, IndexRange({1, 5}));
+    EXPECT_EQ(moves.samples, IndexRange({1, 20}));
+    const auto any = moves.merge({CurveChange::Edit::Append, {5, 6}, IndexRange::all()});
+    EXPECT_EQ(any.edit, CurveChange::Edit::Any);
+    EXPECT_EQ(any.points, IndexRange::all());
+    EXPECT_TRUE(IndexRange({3, 3}).merge({2, 4}) == IndexRange({2, 4}));
+}
+
+TEST(CurveChangeTest, BezierCurvePublishesTheMovedSamples)
+{
+    BezierCurve curve(100);
+    const auto recorder = std::make_shared<ChangeRecorder>();
+    curve.attach(recorder);
+    for(std::size_t i{0}; i < 5; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        curve.add({x * 10., x * x});
+    }
+    ASSERT_EQ(recorder->changes.size(), 5u);
+    EXPECT_EQ(recorder->changes.back().edit, CurveChange::Edit::Append);
+    EXPECT_EQ(recorder->changes.back().points, IndexRange({4, 5}));
+    const auto before = curve.getCurvePoint();
+    curve.updateControlPointAtIndex(2, {25., 10.}, 1.);
+    ASSERT_EQ(recorder->changes.size(), 6u);
+    const auto& moved = recorder->changes.back();
+    EXPECT_EQ(moved.edit, CurveChange::Edit::Move);
+    EXPECT_EQ(moved.points, IndexRange({2, 3}));
+    EXPECT_EQ(moved.samples, IndexRange({1, 100}));
+    // the samples outside of the published range are unchanged
+    const auto& after = curve.getCurvePoint();
+    ASSERT_EQ(after.size(), before.size());
+    for(std::size_t i{0}; i < after.size(); ++i)
+    {
+        EXPECT_EQ(moved.samples.contains(i), glm::distance(after[i], before[i]) > 1e-12) << i;
+    }
+    curve.updateControlPointAtIndex(4, {40., 20.}, 1.);
+    EXPECT_EQ(recorder->changes.back().samples, IndexRange({1, 101}));
+}
+
+TEST(CurveChangeTest, TransactionPublishesOnce)
+{
+    InterpolationCurve curve(InterpolationCurve::Parameters(0, 100, .1));
+    for(std::size_t i{0}; i < 6; ++i)
+    {
+        const auto x = static_cast<double>(i);
+        curve.add({x * 10., x * x - 4. * x});
+    }
+    const auto recorder = std::make_shared<ChangeRecorder>();
+    curve.attach(recorder);
+    {
+        ControlPoints::Transaction transaction(curve);
+        curve.updateControlPointAtIndex(4, {40., 3.}, 1.);
+        curve.updateControlPointAtIndex(1, {10., -2.}, 1.);
+        curve.updateControlPointAtIndex(4, {41., 2.}, 1.);
+        EXPECT_TRUE(recorder->changes.empty());
+        transaction.commit();
+    }
+    ASSERT_EQ(recorder->changes.size(), 1u);
+    EXPECT_EQ(recorder->changes.back().edit, CurveChange::Edit::Move);
+    EXPECT_EQ(recorder->changes.back().points, IndexRange({1, 5}));
+    {
+        ControlPoints::Transaction transaction(curve);
+        curve.add({60., 12.});
+        EXPECT_TRUE(curve.deleteControlPoint({0., 0.}, 1.));
+        transaction.commit();
+    }
+    ASSERT_EQ(recorder->changes.size(), 2u);
+    EXPECT_EQ(recorder->changes.back().edit, CurveChange::Edit::Any);
+    curve.deleteControlPointAtIndex(0);
+    ASSERT_EQ(recorder->changes.size(), 3u);
+    EXPECT_EQ(recorder->changes.back().edit, CurveChange::Edit::Remove);
+    EXPECT_EQ(recorder->changes.back().points, IndexRange({0, 1}));
+    EXPECT_EQ(curve.size(), 5u);
+    curve.detach(recorder);
+    curve.reset();
+    EXPECT_EQ(recorder->changes.size(), 3u);
+}
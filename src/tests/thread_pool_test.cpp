@@ -0,0 +1,102 @@
+#include <AllocationCounter.h>
+#include <curves/interpolation.h>
+#include <curves/ThreadPool.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPoolTest, ParallelForCoversAllElements)
+{
+    ThreadPool pool(3);
+    for(const std::size_t count : {0u, 1u, 7u, 100u, 1001u})
+    {
+        for(const std::size_t grain : {1u, 3u, 64u, 2000u})
+        {
+            std::vector<int> visits(count, 0);
+            pool.parallelFor(count, grain, [&](std::size_t begin, std::size_t end) {
+                EXPECT_LE(end - begin, grain);
+                for(auto i = begin; i < end; ++i)
+                {
+                    ++visits[i];
+                }
+            });
+            for(const auto v : visits)
+            {
+                EXPECT_EQ(v, 1);
+            }
+        }
+    }
+}
+
+TEST(ThreadPoolTest, NestedParallelFor)
+{
+    // the tasks of the pool can use the pool themselves without deadlocking
+    ThreadPool pool(2);
+    std::atomic<std::size_t> sum{0};
+    pool.parallelFor(8, 1, [&](std::size_t, std::size_t) {
+        pool.parallelFor(100, 10, [&](std::size_t begin, std::size_t end) { sum += end - begin; });
+    });
+    EXPECT_EQ(sum, 800u);
+}
+
+TEST(ThreadPoolTest, ParallelForRethrows)
+{
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.parallelFor(100,
+                                  10,
+                                  [](std::size_t begin, std::size_t) {
+                                      if(begin == 50)
+                                      {
+                                          throw std::runtime_error("error");
+                                      }
+                                  }),
+                 std::runtime_error);
+}
+
+TEST(ThreadPoolTest, ParallelForDoesNotAllocate)
+{
+    ThreadPool pool(3);
+    std::atomic<std::size_t> sum{0};
+    const auto add = [&sum](std::size_t begin, std::size_t end) { sum += end - begin; };
+    const auto before = allocationCount();
+    for(std::size_t run{0}; run < 100; ++run)
+    {
+        // nested in the ranges as the curves of InterpolationCurve::update() are
+        pool.parallelFor(4, 1, [&](std::size_t, std::size_t) { pool.parallelFor(64, 8, std::cref(add)); });
+    }
+    EXPECT_EQ(allocationCount() - before, 0u);
+    EXPECT_EQ(sum, 100u * 4u * 64u);
+}
+
+TEST(ThreadPoolTest, DeterministicSubdivision)
+{
+    // a large evaluation split across the threads gives the same result at each run
+    const std::vector<double> X{1.6, 4.6, 1.6, -2.4, -8.4};
+    const std::vector<double> Y{4.25, 8.25, 14.25, 1.25, -6.75};
+    const std::vector<double> T{0., 1., 2., 3., 4.};
+    std::vector<double> tToEval{};
+    for(std::size_t i{0}; i <= 40000; ++i)
+    {
+        tToEval.push_back(static_cast<double>(i) * 1e-4);
+    }
+    const auto W = barycentricWeights(T);
+    const auto reference = applyBarycentricSubdivision(X, Y, T, W, tToEval);
+    for(int run = 0; run < 3; ++run)
+    {
+        const auto res = applyBarycentricSubdivision(X, Y, T, W, tToEval);
+        ASSERT_EQ(res.size(), reference.size());
+        for(std::size_t i{0}; i < res.size(); ++i)
+        {
+            ASSERT_EQ(res[i], reference[i]);
+        }
+    }
+    for(const auto i : {0u, 12345u, 40000u})
+    {
+        EXPECT_NEAR(reference[i].x, lagrange(tToEval[i], T, X), 1e-9);
+        EXPECT_NEAR(reference[i].y, lagrange(tToEval[i], T, Y), 1e-9);
+    }
+}
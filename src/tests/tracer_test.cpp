@@ -0,0 +1,83 @@
+#include <AllocationCounter.h>
+#include <curves/BezierCurve.h>
+#include <curves/ThreadPool.h>
+#include <curves/Tracer.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(TracerTest, RecordsOnlyWhenEnabled)
+{
+    Tracer::setAllocationCounter(threadAllocationCount);
+    auto& tracer = Tracer::instance();
+    tracer.setEnabled(false);
+    tracer.clear();
+    {
+        const TraceScope scope("disabled");
+    }
+    EXPECT_EQ(tracer.size(), 0u);
+
+    tracer.setEnabled(true);
+    {
+        const TraceScope scope("enabled");
+        const std::vector<double> values(100);
+        EXPECT_EQ(values.size(), 100u);
+    }
+    tracer.setEnabled(false);
+    ASSERT_EQ(tracer.size(), 1u);
+
+    std::ostringstream os;
+    tracer.write(os);
+    const auto trace = os.str();
+    EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"enabled\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_EQ(trace.find("disabled"), std::string::npos);
+    // the vector allocated in the scope
+    EXPECT_NE(trace.find("\"allocations\":1}"), std::string::npos);
+    tracer.clear();
+}
+
+TEST(TracerTest, CountsTheAllocationsOfThePool)
+{
+    if(!Tracer::isAvailable())
+    {
+        GTEST_SKIP() << "the library is built without CURVES_ENABLE_TRACING";
+    }
+    Tracer::setAllocationCounter(threadAllocationCount);
+    ThreadPool pool(3);
+    const auto before = Tracer::allocationCount();
+    // the allocations of the helpers are counted for the calling thread
+    pool.parallelFor(8, 1, [](std::size_t begin, std::size_t end) {
+        const std::vector<double> values(end - begin + 1);
+        EXPECT_FALSE(values.empty());
+    });
+    EXPECT_GE(Tracer::allocationCount() - before, 8u);
+}
+
+TEST(TracerTest, InstrumentsTheHotPaths)
+{
+    if(!Tracer::isAvailable())
+    {
+        GTEST_SKIP() << "the library is built without CURVES_ENABLE_TRACING";
+    }
+    auto& tracer = Tracer::instance();
+    tracer.clear();
+    tracer.setEnabled(true);
+    BezierCurve curve(100);
+    curve.add({0., 0.});
+    curve.add({1., 1.});
+    EXPECT_TRUE(curve.getIndexClosestPoint({1., 1.}, 1.).has_value());
+    tracer.setEnabled(false);
+
+    std::ostringstream os;
+    tracer.write(os);
+    const auto trace = os.str();
+    EXPECT_NE(trace.find("\"name\":\"BezierCurve::add\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"BezierCurve::make\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"ControlPoints::getIndexClosestPoint\""), std::string::npos);
+    tracer.clear();
+}